@@ -58,4 +58,30 @@ namespace embree
   };
 
   parallel_for_regression_test parallel_for_regression("parallel_for_regression_test");
+
+#if defined(TASKING_INTERNAL)
+  struct task_stack_growth_regression_test : public RegressionTest
+  {
+    task_stack_growth_regression_test(const char* name) : RegressionTest(name) {
+      registerRegressionTest(this);
+    }
+    
+    bool run ()
+    {
+      /* spawns more tasks and closures than fit into the first
+       * segments of the task stack and closure stack */
+      const size_t N = 100000;
+      std::atomic<size_t> sum(0);
+      TaskScheduler::spawn([&] () 
+      {
+        for (size_t i=0; i<N; i++)
+          TaskScheduler::spawn([&sum,i] () { sum += i; });
+        TaskScheduler::wait();
+      });
+      return sum == N*(N-1)/2;
+    }
+  };
+
+  task_stack_growth_regression_test task_stack_growth_regression("task_stack_growth_regression_test");
+#endif
 }
@@ -57,6 +57,35 @@ namespace embree
         for (size_t i=0; i<split; i++) passed &= array[i] < split;
         for (size_t i=split; i<N; i++) passed &= array[i] >= split;
       }
+
+      /* test blocked partitioning */
+      for (size_t i=0; i<100; i++)
+      {
+        size_t N = 1+std::rand() % ((i%2) ? 100000 : 1000);
+        std::vector<unsigned> array(N);
+        for (unsigned i=0; i<N; i++) array[i] = i;
+        for (auto& v : array) std::swap(v,array[std::rand()%array.size()]);
+        size_t split = std::rand() % (N+1);
+
+        auto is_left = [&] ( size_t i ) { return i < split; };
+        auto is_left_block = [&] ( const unsigned* v ) {
+          size_t mask = 0;
+          for (size_t i=0; i<SERIAL_PARTITION_BLOCK_SIZE; i++) mask |= size_t(v[i] < split) << i;
+          return mask;
+        };
+
+        size_t left_sum = 0, right_sum = 0;
+        size_t mid = parallel_partitioning(array.data(),0,array.size(),0,left_sum,right_sum,is_left,is_left_block,
+                                           []  ( size_t& sum, unsigned v) { sum += v; },
+                                           []  ( size_t& sum, size_t v) { sum += v; },
+                                           128,(i%4) < 2 ? 1024 : N+1);
+
+        passed &= mid == split;
+        passed &= left_sum == split*(split-1)/2;
+        passed &= right_sum == N*(N-1)/2-left_sum;
+        for (size_t i=0; i<split; i++) passed &= array[i] < split;
+        for (size_t i=split; i<N; i++) passed &= array[i] >= split;
+      }
       
       return passed;
     }
@@ -61,7 +61,76 @@ namespace embree
     return l - array;        
   }
 
-  template<typename T, typename V, typename Vi, typename IsLeft, typename Reduction_T, typename Reduction_V>
+  /* number of items the blocked serial partitioning classifies at once */
+  static const size_t SERIAL_PARTITION_BLOCK_SIZE = 8*sizeof(size_t);
+
+  /* blocked serial partitioning: is_left_block classifies a block of
+   * SERIAL_PARTITION_BLOCK_SIZE items at once and returns a bit mask of
+   * the items that belong to the left side, thus the classification can
+   * use SIMD instructions and has no data dependent branches. Only the
+   * misplaced items of a block at the left and right end get swapped
+   * afterwards, the last items are partitioned with the scalar code. */
+  template<typename T, typename V, typename IsLeft, typename IsLeftBlock, typename Reduction_T>
+    __forceinline size_t serial_partitioning(T* array, 
+                                             const size_t begin,
+                                             const size_t end, 
+                                             V& leftReduction,
+                                             V& rightReduction,
+                                             const IsLeft& is_left, 
+                                             const IsLeftBlock& is_left_block, 
+                                             const Reduction_T& reduction_t)
+  {
+    const size_t B = SERIAL_PARTITION_BLOCK_SIZE;
+    T* l = array + begin;
+    T* r = array + end;
+    size_t misplacedLeft = 0;  //!< items of block [l,l+B) that belong to the right
+    size_t misplacedRight = 0; //!< items of block [r-B,r) that belong to the left
+    bool classifyLeft = true;
+    bool classifyRight = true;
+    
+    while (size_t(r-l) >= 2*B)
+    {
+      if (classifyLeft ) { misplacedLeft  = ~is_left_block(l);  classifyLeft  = false; }
+      if (classifyRight) { misplacedRight =  is_left_block(r-B); classifyRight = false; }
+
+      /* swap misplaced items of both blocks */
+      T* rb = r-B;
+      while (misplacedLeft && misplacedRight) {
+        const size_t i = __bscf(misplacedLeft);
+        const size_t j = __bscf(misplacedRight);
+        xchg(l[i],rb[j]);
+      }
+
+      /* continue with the next block when all items of a block are on the correct side */
+      if (misplacedLeft == 0) {
+        for (size_t i=0; i<B; i++) reduction_t(leftReduction,l[i]);
+        l += B; classifyLeft = true;
+      }
+      if (misplacedRight == 0) {
+        for (size_t i=0; i<B; i++) reduction_t(rightReduction,rb[i]);
+        r -= B; classifyRight = true;
+      }
+    }
+
+    /* the remaining items may contain some partially processed block */
+    return serial_partitioning(array,l-array,r-array,leftReduction,rightReduction,is_left,reduction_t);
+  }
+
+  /* serial partitioning without block classification */
+  template<typename T, typename V, typename IsLeft, typename Reduction_T>
+    __forceinline size_t serial_partitioning(T* array, 
+                                             const size_t begin,
+                                             const size_t end, 
+                                             V& leftReduction,
+                                             V& rightReduction,
+                                             const IsLeft& is_left, 
+                                             const EmptyTy& is_left_block, 
+                                             const Reduction_T& reduction_t)
+  {
+    return serial_partitioning(array,begin,end,leftReduction,rightReduction,is_left,reduction_t);
+  }
+
+  template<typename T, typename V, typename Vi, typename IsLeft, typename IsLeftBlock, typename Reduction_T, typename Reduction_V>
     class __aligned(64) parallel_partition_task
   {
     ALIGNED_CLASS;
@@ -72,6 +141,7 @@ namespace embree
     T* array;
     size_t N;
     const IsLeft& is_left;
+    const IsLeftBlock& is_left_block;
     const Reduction_T& reduction_t;
     const Reduction_V& reduction_v;
     const Vi& identity;
@@ -90,11 +160,12 @@ namespace embree
                                           const size_t N, 
                                           const Vi& identity, 
                                           const IsLeft& is_left, 
+                                          const IsLeftBlock& is_left_block, 
                                           const Reduction_T& reduction_t, 
                                           const Reduction_V& reduction_v,
                                           const size_t BLOCK_SIZE) 
 
-      : array(array), N(N), is_left(is_left), reduction_t(reduction_t), reduction_v(reduction_v), identity(identity),
+      : array(array), N(N), is_left(is_left), is_left_block(is_left_block), reduction_t(reduction_t), reduction_v(reduction_v), identity(identity),
       numTasks(min((N+BLOCK_SIZE-1)/BLOCK_SIZE,min(TaskScheduler::threadCount(),MAX_TASKS))) {}
 
     __forceinline const range<ssize_t>* findStartRange(size_t& index, const range<ssize_t>* const r, const size_t numRanges)
@@ -163,7 +234,7 @@ namespace embree
           const size_t endID   = (taskID+1)*N/numTasks;
           V local_left(identity);
           V local_right(identity);
-          const size_t mid = serial_partitioning(array,startID,endID,local_left,local_right,is_left,reduction_t);
+          const size_t mid = serial_partitioning(array,startID,endID,local_left,local_right,is_left,is_left_block,reduction_t);
           counter_start[taskID] = startID;
           counter_left [taskID] = mid-startID;
           leftReductions[taskID]  = local_left;
@@ -245,8 +316,8 @@ namespace embree
 
     /* otherwise use parallel code */
     else {
-      typedef parallel_partition_task<T,V,Vi,IsLeft,Reduction_T,Reduction_V> partition_task;
-      std::unique_ptr<partition_task> p(new partition_task(&array[begin],end-begin,identity,is_left,reduction_t,reduction_v,BLOCK_SIZE));
+      typedef parallel_partition_task<T,V,Vi,IsLeft,EmptyTy,Reduction_T,Reduction_V> partition_task;
+      std::unique_ptr<partition_task> p(new partition_task(&array[begin],end-begin,identity,is_left,empty,reduction_t,reduction_v,BLOCK_SIZE));
       return begin+p->partition(leftReduction,rightReduction);    
     }
   }
@@ -270,8 +341,35 @@ namespace embree
 
     /* otherwise use parallel code */
     else {
-      typedef parallel_partition_task<T,V,Vi,IsLeft,Reduction_T,Reduction_V> partition_task;
-      std::unique_ptr<partition_task> p(new partition_task(&array[begin],end-begin,identity,is_left,reduction_t,reduction_v,BLOCK_SIZE));
+      typedef parallel_partition_task<T,V,Vi,IsLeft,EmptyTy,Reduction_T,Reduction_V> partition_task;
+      std::unique_ptr<partition_task> p(new partition_task(&array[begin],end-begin,identity,is_left,empty,reduction_t,reduction_v,BLOCK_SIZE));
+      return begin+p->partition(leftReduction,rightReduction);    
+    }
+  }
+
+  /* parallel partitioning that uses the blocked serial partitioning for each task */
+  template<typename T, typename V, typename Vi, typename IsLeft, typename IsLeftBlock, typename Reduction_T, typename Reduction_V>
+    __noinline size_t parallel_partitioning(T* array, 
+                                            const size_t begin,
+                                            const size_t end, 
+                                            const Vi &identity,
+                                            V &leftReduction,
+                                            V &rightReduction,
+                                            const IsLeft& is_left, 
+                                            const IsLeftBlock& is_left_block, 
+                                            const Reduction_T& reduction_t,
+                                            const Reduction_V& reduction_v,
+                                            size_t BLOCK_SIZE,
+                                            size_t PARALLEL_THRESHOLD)
+  {
+    /* fall back to single threaded partitioning for small N */
+    if (unlikely(end-begin < PARALLEL_THRESHOLD))
+      return serial_partitioning(array,begin,end,leftReduction,rightReduction,is_left,is_left_block,reduction_t);
+
+    /* otherwise use parallel code */
+    else {
+      typedef parallel_partition_task<T,V,Vi,IsLeft,IsLeftBlock,Reduction_T,Reduction_V> partition_task;
+      std::unique_ptr<partition_task> p(new partition_task(&array[begin],end-begin,identity,is_left,is_left_block,reduction_t,reduction_v,BLOCK_SIZE));
       return begin+p->partition(leftReduction,rightReduction);    
     }
   }
@@ -144,6 +144,14 @@ namespace embree
         }
       }
 
+      /* allocates n consecutive new IDs and returns the first one */
+      T allocateRange(T n)
+      {
+        T id = nextID;
+        nextID += n;
+        return id;
+      }
+
       /* adds an ID provided by the user */
       bool add(T id)
       {
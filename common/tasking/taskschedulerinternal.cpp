@@ -22,13 +22,20 @@
 namespace embree
 {
   size_t TaskScheduler::g_numThreads = 0;
+  ssize_t TaskScheduler::g_idleSpinTime = -1;
+  TaskScheduler::External TaskScheduler::g_external;
+  std::atomic<bool> TaskScheduler::g_hasExternal(false);
+  __thread ssize_t TaskScheduler::g_externalThreadIndex = -1;
   __thread TaskScheduler* TaskScheduler::g_instance = nullptr;
   __thread TaskScheduler::Thread* TaskScheduler::thread_local_thread = nullptr;
   TaskScheduler::ThreadPool* TaskScheduler::threadPool = nullptr;
 
   template<typename Predicate, typename Body>
-  __forceinline void TaskScheduler::steal_loop(Thread& thread, const Predicate& pred, const Body& body)
+  __forceinline void TaskScheduler::steal_loop(Thread& thread, const Predicate& pred, const Body& body, bool park)
   {
+    park &= g_idleSpinTime >= 0;
+    double t0 = park ? getSeconds() : 0.0;
+
     while (true)
     {
       /*! some rounds that yield */
@@ -42,13 +49,78 @@ namespace embree
           if (thread.scheduler->steal_from_other_threads(thread)) {
             i=j=0;
             body();
+            if (park) t0 = getSeconds();
           }
         }
         yield();
+
+        /*! park thread after spinning for some time without finding work */
+        if (park && getSeconds()-t0 >= 1E-6*double(g_idleSpinTime)) {
+          thread.scheduler->park(pred);
+          i=0; t0 = getSeconds();
+        }
       }
     }
   }
 
+  template<typename Predicate>
+  void TaskScheduler::park(const Predicate& pred)
+  {
+    Lock<MutexSys> lock(idleMutex);
+    const size_t counter = wakeupCounter;
+
+    /* tasks spawned or a predicate changed before the parked thread
+     * got counted do not wake us up, thus we have to check again */
+    numParkedThreads++;
+    if (pred() && !anyTasksAvailable())
+      idleCondition.wait(idleMutex, [&] () { return wakeupCounter != counter || !pred(); });
+    numParkedThreads--;
+  }
+
+  bool TaskScheduler::anyTasksAvailable()
+  {
+    const size_t threadCount = threadCounter;
+    for (size_t i=0; i<threadCount; i++) {
+      Thread* thread = threadLocal[i].load();
+      if (thread && thread->tasks.left < thread->tasks.right) return true;
+    }
+    return false;
+  }
+
+  __dllexport void TaskScheduler::leave()
+  {
+    threadCounter--;
+    if (numParkedThreads > 0) wakeup();
+
+    const double t0 = getSeconds();
+#if defined(__WIN32__)
+	size_t loopIndex = 1;
+#endif
+#define LOOP_YIELD_THRESHOLD (4096)
+	while (threadCounter > 0) {
+#if defined(__WIN32__)
+          if ((loopIndex % LOOP_YIELD_THRESHOLD) == 0)
+            yield();
+          else
+            _mm_pause();
+	  loopIndex++;
+#else
+          yield();
+#endif
+          /*! a thread may still execute a long running task, thus park after some time */
+          if (g_idleSpinTime >= 0 && getSeconds()-t0 >= 1E-6*double(g_idleSpinTime))
+            park([&] () { return threadCounter > 0; });
+	}
+  }
+
+  __dllexport void TaskScheduler::wakeup()
+  {
+    idleMutex.lock();
+    wakeupCounter++;
+    idleMutex.unlock();
+    idleCondition.notify_all();
+  }
+
   /*! run this task */
   __dllexport void TaskScheduler::Task::run (Thread& thread) // FIXME: avoid as many __dllexports as possible
   {
@@ -71,30 +143,33 @@ namespace embree
     /* steal until all dependencies have completed */
     steal_loop(thread,
                [&] () { return dependencies>0; },
-               [&] () { while (thread.tasks.execute_local(thread,this)); });
+               [&] () { while (thread.tasks.execute_local(thread,this)); },
+               true);
 
     /* now signal our parent task that we are finished */
-    if (parent)
+    if (parent) {
       parent->add_dependencies(-1);
+      if (thread.scheduler->numParkedThreads > 0) thread.scheduler->wakeup();
+    }
   }
 
   __dllexport bool TaskScheduler::TaskQueue::execute_local(Thread& thread, Task* parent)
   {
     /* stop if we run out of local tasks or reach the waiting task */
-    if (right == 0 || &tasks[right-1] == parent)
+    if (right == 0 || &task(right-1) == parent)
       return false;
 
     /* execute task */
     size_t oldRight = right;
-    tasks[right-1].run(thread);
+    task(right-1).run(thread);
     if (right != oldRight) {
       THROW_RUNTIME_ERROR("you have to wait for spawned subtasks");
     }
 
     /* pop task and closure from stack */
     right--;
-    if (tasks[right].stackPtr != size_t(-1))
-      stackPtr = tasks[right].stackPtr;
+    if (task(right).stackPtr != size_t(-1))
+      stackPtr = task(right).stackPtr;
 
     /* also move left pointer */
     if (left >= right) left.store(right.load());
@@ -102,28 +177,60 @@ namespace embree
     return right != 0;
   }
 
+  __dllexport TaskScheduler::TaskQueue::TaskQueue ()
+    : left(0), right(0), stackPtr(0)
+  {
+    for (size_t k=0; k<MAX_TASK_SEGMENTS; k++) taskSegments[k].store(nullptr);
+    for (size_t k=0; k<MAX_CLOSURE_SEGMENTS; k++) closureSegments[k] = nullptr;
+  }
+
+  __dllexport TaskScheduler::TaskQueue::~TaskQueue ()
+  {
+    for (size_t k=0; k<MAX_TASK_SEGMENTS; k++) {
+      Task* segment = taskSegments[k].load();
+      if (segment == nullptr) break;
+      for (size_t i=0; i<(TASK_SEGMENT_SIZE << k); i++) segment[i].~Task();
+      alignedFree(segment);
+    }
+    for (size_t k=0; k<MAX_CLOSURE_SEGMENTS; k++) {
+      if (closureSegments[k] == nullptr) break;
+      alignedFree(closureSegments[k]);
+    }
+  }
+
+  __dllexport void TaskScheduler::TaskQueue::allocTaskSegment(size_t k)
+  {
+    if (k >= MAX_TASK_SEGMENTS) 
+      THROW_RUNTIME_ERROR("task stack overflow");
+
+    const size_t N = TASK_SEGMENT_SIZE << k;
+    Task* segment = (Task*) alignedMalloc(N*sizeof(Task),64);
+    for (size_t i=0; i<N; i++) new (&segment[i]) Task;
+    taskSegments[k].store(segment,std::memory_order_release);
+  }
+
+  __dllexport void TaskScheduler::TaskQueue::allocClosureSegment(size_t k)
+  {
+    if (k >= MAX_CLOSURE_SEGMENTS) 
+      THROW_RUNTIME_ERROR("closure stack overflow");
+
+    closureSegments[k] = (char*) alignedMalloc(CLOSURE_SEGMENT_SIZE,64);
+  }
+
   bool TaskScheduler::TaskQueue::steal(Thread& thread)
   {
+    /* claim the leftmost task */
     size_t l = left;
-    if (l < right)
-      l = left++;
-    else
-      return false;
+    if (l >= right) return false;
+    if (!left.compare_exchange_strong(l,l+1)) return false;
 
-    if (!tasks[l].try_steal(thread.tasks.tasks[thread.tasks.right]))
+    if (!task(l).try_steal(thread.tasks.next_task()))
       return false;
 
     thread.tasks.right++;
     return true;
   }
 
-  /* we steal from the left */
-  size_t TaskScheduler::TaskQueue::getTaskSizeAtLeft()
-  {
-    if (left >= right) return 0;
-    return tasks[left].N;
-  }
-
   static MutexSys g_mutex;
 
   void threadPoolFunction(std::pair<TaskScheduler::ThreadPool*,size_t>* pair)
@@ -190,8 +297,11 @@ namespace embree
 
   __dllexport void TaskScheduler::ThreadPool::add(const Ref<TaskScheduler>& scheduler)
   {
+    /* keep schedulers sorted by priority */
     mutex.lock();
-    schedulers.push_back(scheduler);
+    auto it = schedulers.begin();
+    while (it != schedulers.end() && (*it)->priority >= scheduler->priority) it++;
+    schedulers.insert(it,scheduler);
     mutex.unlock();
     condition.notify_all();
   }
@@ -207,6 +317,13 @@ namespace embree
     }
   }
 
+  TaskScheduler* TaskScheduler::ThreadPool::findScheduler()
+  {
+    for (auto& scheduler : schedulers)
+      if (scheduler->acceptsThread()) return scheduler.ptr;
+    return nullptr;
+  }
+
   void TaskScheduler::ThreadPool::thread_loop(size_t globalThreadIndex)
   {
     while (globalThreadIndex < numThreadsRunning)
@@ -215,17 +332,18 @@ namespace embree
       ssize_t threadIndex = -1;
       {
         Lock<MutexSys> lock(mutex);
-        condition.wait(mutex, [&] () { return globalThreadIndex >= numThreadsRunning || !schedulers.empty(); });
+        condition.wait(mutex, [&] () { return globalThreadIndex >= numThreadsRunning || findScheduler() != nullptr; });
         if (globalThreadIndex >= numThreadsRunning) break;
-        scheduler = schedulers.front();
+        scheduler = findScheduler();
         threadIndex = scheduler->allocThreadIndex();
       }
       scheduler->thread_loop(threadIndex);
     }
   }
 
-  TaskScheduler::TaskScheduler()
-    : threadCounter(0), anyTasksRunning(0), hasRootTask(false)
+  TaskScheduler::TaskScheduler(size_t maxThreads, int priority)
+    : threadCounter(0), anyTasksRunning(0), hasRootTask(false), maxThreads(maxThreads), priority(priority),
+      numParkedThreads(0), wakeupCounter(0)
   {
     threadLocal.resize(2*getNumberOfLogicalThreads()); // FIXME: this has to be 2x as in the compatibility join mode with rtcCommit the worker threads also join. When disallowing rtcCommit to join a build we can remove the 2x.
     for (size_t i=0; i<threadLocal.size(); i++)
@@ -239,6 +357,7 @@ namespace embree
 
   __dllexport size_t TaskScheduler::threadID()
   {
+    if (g_externalThreadIndex >= 0) return g_externalThreadIndex;
     Thread* thread = TaskScheduler::thread();
     if (thread) return thread->threadIndex;
     else        return 0;
@@ -246,15 +365,38 @@ namespace embree
 
   __dllexport size_t TaskScheduler::threadIndex()
   {
+    if (g_externalThreadIndex >= 0) return g_externalThreadIndex;
     Thread* thread = TaskScheduler::thread();
     if (thread) return thread->threadIndex;
     else        return 0;
   }
 
-  __dllexport size_t TaskScheduler::threadCount() {
+  __dllexport size_t TaskScheduler::threadCount() 
+  {
+    if (g_hasExternal) return g_external.numThreads;
     return threadPool->size();
   }
 
+  __dllexport void TaskScheduler::setExternal(ExternalParallelForFunc func, void* userPtr, size_t numThreads)
+  {
+    g_hasExternal = false;
+    g_external.parallel_for = func;
+    g_external.userPtr = userPtr;
+    g_external.numThreads = numThreads;
+    g_hasExternal = func != nullptr;
+  }
+
+  __dllexport const TaskScheduler::External* TaskScheduler::external() {
+    return g_hasExternal ? &g_external : nullptr;
+  }
+
+  __dllexport ssize_t TaskScheduler::swapExternalThreadIndex(ssize_t threadIndex)
+  {
+    ssize_t old = g_externalThreadIndex;
+    g_externalThreadIndex = threadIndex;
+    return old;
+  }
+
   __dllexport TaskScheduler* TaskScheduler::instance()
   {
     if (g_instance == NULL) {
@@ -264,8 +406,9 @@ namespace embree
     return g_instance;
   }
 
-  void TaskScheduler::create(size_t numThreads, bool set_affinity, bool start_threads)
+  void TaskScheduler::create(size_t numThreads, bool set_affinity, bool start_threads, ssize_t idle_spin_time)
   {
+    g_idleSpinTime = idle_spin_time;
     if (!threadPool) threadPool = new TaskScheduler::ThreadPool(set_affinity);
     threadPool->setNumThreads(numThreads,start_threads);
   }
@@ -336,8 +479,9 @@ namespace embree
                  [&] () {
                    anyTasksRunning++;
                    while (thread.tasks.execute_local(thread,nullptr));
-                   anyTasksRunning--;
-                 });
+                   if (--anyTasksRunning == 0 && numParkedThreads > 0) wakeup();
+                 },
+                 true);
     }
     threadLocal[threadIndex].store(nullptr);
     swapThread(oldThread);
@@ -347,22 +491,7 @@ namespace embree
     if (cancellingException != nullptr) except = cancellingException;
 
     /* wait for all threads to terminate */
-    threadCounter--;
-#if defined(__WIN32__)
-	size_t loopIndex = 1;
-#endif
-#define LOOP_YIELD_THRESHOLD (4096)
-	while (threadCounter > 0) {
-#if defined(__WIN32__)
-          if ((loopIndex % LOOP_YIELD_THRESHOLD) == 0)
-            yield();
-          else
-            _mm_pause();
-	  loopIndex++;
-#else
-          yield();
-#endif
-	}
+    leave();
     return except;
   }
 
@@ -35,11 +35,64 @@ namespace embree
     ALIGNED_STRUCT;
     friend class Device;
 
-    static const size_t TASK_STACK_SIZE = 2*1024;           //!< task structure stack
-    static const size_t CLOSURE_STACK_SIZE = 256*1024;    //!< stack for task closures
+    static const size_t TASK_SEGMENT_SIZE = 1024;          //!< number of tasks of first task stack segment, segments double in size
+    static const size_t MAX_TASK_SEGMENTS = 32;            //!< maximal number of task stack segments
+    static const size_t CLOSURE_SEGMENT_SIZE = 64*1024;    //!< size of segments of the stack for task closures
+    static const size_t MAX_CLOSURE_SEGMENTS = 1024;       //!< maximal number of closure stack segments
 
     struct Thread;
 
+    /*! task function of an external tasking system */
+    typedef void (*ExternalTaskFunc)(void* taskPtr, size_t threadIndex, size_t taskIndex);
+
+    /*! parallel for function of an external tasking system, has to
+     *  invoke func for each task index in [0,taskCount) and return
+     *  after all invocations finished */
+    typedef void (*ExternalParallelForFunc)(void* userPtr, ExternalTaskFunc func, void* taskPtr, size_t taskCount);
+
+    /*! external tasking system all task sets get dispatched to */
+    struct External
+    {
+      External ()
+        : parallel_for(nullptr), userPtr(nullptr), numThreads(0) {}
+
+      ExternalParallelForFunc parallel_for;
+      void* userPtr;
+      size_t numThreads;  //!< number of threads of the external tasking system
+    };
+
+    /*! task set executed by an external tasking system */
+    template<typename Index, typename Closure>
+    struct ExternalTaskSet
+    {
+      __forceinline ExternalTaskSet (const Index begin, const Index end, const Index blockSize, const Closure& closure)
+        : begin(begin), end(end), blockSize(blockSize), closure(closure), cancelled(false), except(nullptr) {}
+
+      static void run(void* taskPtr, size_t threadIndex, size_t taskIndex)
+      {
+        ExternalTaskSet* set = (ExternalTaskSet*) taskPtr;
+        if (set->cancelled) return;
+
+        const Index b = set->begin + Index(taskIndex)*set->blockSize;
+        const Index e = min(set->end,b+set->blockSize);
+        const ssize_t oldThreadIndex = swapExternalThreadIndex(threadIndex);
+        try {
+          set->closure(range<Index>(b,e));
+        } catch (...) {
+          Lock<SpinLock> lock(set->mutex);
+          if (set->except == nullptr) set->except = std::current_exception();
+          set->cancelled = true;
+        }
+        swapExternalThreadIndex(oldThreadIndex);
+      }
+
+      const Index begin, end, blockSize;
+      const Closure& closure;
+      std::atomic<bool> cancelled;
+      std::exception_ptr except;
+      SpinLock mutex;
+    };
+
     /*! virtual interface for all tasks */
     struct TaskFunction {
       virtual void execute() = 0;
@@ -119,46 +172,87 @@ namespace embree
       size_t N;                          //!< approximative size of task
     };
 
+    /*! Work stealing deque of tasks in the style of Chase and Lev.
+     *  The owning thread pushes and pops tasks at the right end,
+     *  other threads steal from the left end. The task stack and the
+     *  closure stack grow in segments that never move in memory, as
+     *  tasks point to their parent task and to their closure. */
     struct TaskQueue
     {
-      TaskQueue ()
-      : left(0), right(0), stackPtr(0) {}
+      __dllexport TaskQueue ();
+      __dllexport ~TaskQueue ();
+
+      /*! returns the task at some index of the task stack */
+      __forceinline Task& task(size_t index) const
+      {
+        const size_t k = __bsr(index/TASK_SEGMENT_SIZE+1);
+        const size_t i = index - TASK_SEGMENT_SIZE*((size_t(1) << k)-1);
+        return taskSegments[k].load(std::memory_order_acquire)[i];
+      }
+
+      /*! returns the next free task of the task stack */
+      __forceinline Task& next_task()
+      {
+        const size_t k = __bsr(right/TASK_SEGMENT_SIZE+1);
+        if (unlikely(taskSegments[k].load(std::memory_order_relaxed) == nullptr)) 
+          allocTaskSegment(k);
+        return task(right);
+      }
 
-      __forceinline void* alloc(size_t bytes, size_t align = 64) {
-        stackPtr += bytes + ((align - stackPtr) & (align-1));
-        assert(stackPtr <= CLOSURE_STACK_SIZE);
-        return &stack[stackPtr-bytes];
+      __forceinline void* alloc(size_t bytes, size_t align = 64) 
+      {
+        /* closures do not cross segment boundaries */
+        size_t ptr = stackPtr + ((align - stackPtr) & (align-1));
+        if (unlikely((ptr % CLOSURE_SEGMENT_SIZE) + bytes > CLOSURE_SEGMENT_SIZE)) {
+          if (bytes > CLOSURE_SEGMENT_SIZE) THROW_RUNTIME_ERROR("task closure too large");
+          ptr = (stackPtr + CLOSURE_SEGMENT_SIZE-1) & ~(CLOSURE_SEGMENT_SIZE-1);
+        }
+        const size_t k = ptr / CLOSURE_SEGMENT_SIZE;
+        if (unlikely(k >= MAX_CLOSURE_SEGMENTS || closureSegments[k] == nullptr)) 
+          allocClosureSegment(k);
+        stackPtr = ptr + bytes;
+        return &closureSegments[k][ptr % CLOSURE_SEGMENT_SIZE];
       }
 
       template<typename Closure>
       __forceinline void push_right(Thread& thread, const size_t size, const Closure& closure)
       {
-        assert(right < TASK_STACK_SIZE);
-
 	/* allocate new task on right side of stack */
         size_t oldStackPtr = stackPtr;
         TaskFunction* func = new (alloc(sizeof(ClosureTaskFunction<Closure>))) ClosureTaskFunction<Closure>(closure);
-        new (&tasks[right++]) Task(func,thread.task,oldStackPtr,size);
+        new (&next_task()) Task(func,thread.task,oldStackPtr,size);
+        right++;
 
 	/* also move left pointer */
 	if (left >= right-1) left = right-1;
+
+        /* wake up parked threads to steal the new task */
+        if (unlikely(thread.scheduler->numParkedThreads > 0))
+          thread.scheduler->wakeup();
       }
 
       __dllexport bool execute_local(Thread& thread, Task* parent);
       bool steal(Thread& thread);
-      size_t getTaskSizeAtLeft();
 
       bool empty() { return right == 0; }
 
+    private:
+
+      /*! allocates a new segment of the task stack */
+      __dllexport void allocTaskSegment(size_t k);
+
+      /*! allocates a new segment of the closure stack */
+      __dllexport void allocClosureSegment(size_t k);
+
     public:
 
       /* task stack */
-      Task tasks[TASK_STACK_SIZE];
+      std::atomic<Task*> taskSegments[MAX_TASK_SEGMENTS]; //!< segment k stores TASK_SEGMENT_SIZE*2^k tasks
       __aligned(64) std::atomic<size_t> left;   //!< threads steal from left
       __aligned(64) std::atomic<size_t> right;  //!< new tasks are added to the right
 
       /* closure stack */
-      __aligned(64) char stack[CLOSURE_STACK_SIZE];
+      __aligned(64) char* closureSegments[MAX_CLOSURE_SEGMENTS];
       size_t stackPtr;
     };
 
@@ -204,6 +298,11 @@ namespace embree
       /*! main loop for all threads */
       void thread_loop(size_t threadIndex);
 
+    private:
+
+      /*! returns the scheduler with highest priority that can accept another thread */
+      TaskScheduler* findScheduler();
+
     private:
       std::atomic<size_t> numThreads;
       std::atomic<size_t> numThreadsRunning;
@@ -217,11 +316,18 @@ namespace embree
       std::list<Ref<TaskScheduler> > schedulers;
     };
 
-    TaskScheduler ();
+    TaskScheduler (size_t maxThreads = 0, int priority = 0);
     ~TaskScheduler ();
 
-    /*! initializes the task scheduler */
-    static void create(size_t numThreads, bool set_affinity, bool start_threads);
+    /*! checks if another thread of the thread pool can join this scheduler */
+    __forceinline bool acceptsThread() const {
+      return maxThreads == 0 || threadCounter < maxThreads;
+    }
+
+    /*! initializes the task scheduler, idle threads spin for
+     *  idle_spin_time microseconds before they park, a negative spin
+     *  time lets idle threads spin until new tasks arrive */
+    static void create(size_t numThreads, bool set_affinity, bool start_threads, ssize_t idle_spin_time = -1);
 
     /*! destroys the task scheduler again */
     static void destroy();
@@ -243,12 +349,27 @@ namespace embree
     bool steal_from_other_threads(Thread& thread);
 
     template<typename Predicate, typename Body>
-      static void steal_loop(Thread& thread, const Predicate& pred, const Body& body);
+      static void steal_loop(Thread& thread, const Predicate& pred, const Body& body, bool park = false);
+
+    /*! parks an idle thread until new tasks get spawned or the predicate fails */
+    template<typename Predicate>
+      void park(const Predicate& pred);
+
+    /*! leaves the scheduler and waits until all other threads left it too */
+    __dllexport void leave();
+
+    /*! checks if some thread has tasks that can get stolen */
+    bool anyTasksAvailable();
+
+    /*! wakes up all parked threads */
+    __dllexport void wakeup();
 
     /* spawn a new task at the top of the threads task stack */
     template<typename Closure>
       void spawn_root(const Closure& closure, size_t size = 1, bool useThreadPool = true)
     {
+      /* the threads of an external tasking system execute all task sets */
+      if (external()) useThreadPool = false;
       if (useThreadPool) startThreads();
 
       size_t threadIndex = allocThreadIndex();
@@ -269,6 +390,7 @@ namespace embree
 
       while (thread.tasks.execute_local(thread,nullptr));
       anyTasksRunning--;
+      if (numParkedThreads > 0) wakeup();
       if (useThreadPool) removeScheduler(this);
 
       threadLocal[threadIndex] = nullptr;
@@ -279,8 +401,7 @@ namespace embree
       if (cancellingException != nullptr) except = cancellingException;
 
       /* wait for all threads to terminate */
-      threadCounter--;
-      while (threadCounter > 0) yield();
+      leave();
       cancellingException = nullptr;
 
       /* re-throw proper exception */
@@ -306,6 +427,16 @@ namespace embree
     /* spawn a new task set  */
     template<typename Index, typename Closure>
     static void spawn(const Index begin, const Index end, const Index blockSize, const Closure& closure)
+    {
+      if (unlikely(external() != nullptr))
+        spawn_external(begin,end,blockSize,closure);
+      else
+        spawn_internal(begin,end,blockSize,closure);
+    }
+
+    /* spawn a new task set that recursively splits into subtasks */
+    template<typename Index, typename Closure>
+    static void spawn_internal(const Index begin, const Index end, const Index blockSize, const Closure& closure)
     {
       spawn(end-begin, [=,&closure]()
         {
@@ -313,12 +444,25 @@ namespace embree
 	    return closure(range<Index>(begin,end));
 	  }
 	  const Index center = (begin+end)/2;
-	  spawn(begin,center,blockSize,closure);
-	  spawn(center,end  ,blockSize,closure);
+	  spawn_internal(begin,center,blockSize,closure);
+	  spawn_internal(center,end  ,blockSize,closure);
 	  wait();
 	});
     }
 
+    /* executes a task set with the external tasking system, returns after all tasks finished */
+    template<typename Index, typename Closure>
+    static void spawn_external(const Index begin, const Index end, const Index blockSize, const Closure& closure)
+    {
+      if (begin >= end) return;
+      const External* ext = external();
+      const Index numTasks = (end-begin+blockSize-1)/blockSize;
+      ExternalTaskSet<Index,Closure> set(begin,end,blockSize,closure);
+      ext->parallel_for(ext->userPtr,&ExternalTaskSet<Index,Closure>::run,&set,size_t(numTasks));
+      if (set.except != nullptr)
+        std::rethrow_exception(set.except);
+    }
+
     /* work on spawned subtasks and wait until all have finished */
     __dllexport static bool wait();
 
@@ -331,8 +475,17 @@ namespace embree
     /* returns the total number of threads */
     __dllexport static size_t threadCount();
 
+    /* sets the external tasking system, a null function switches back to the internal one */
+    __dllexport static void setExternal(ExternalParallelForFunc func, void* userPtr, size_t numThreads);
+
+    /* returns the external tasking system or null if none is set */
+    __dllexport static const External* external();
+
   private:
 
+    /* sets the thread index passed by the external tasking system */
+    __dllexport static ssize_t swapExternalThreadIndex(ssize_t threadIndex);
+
     /* returns the thread local task list of this worker thread */
     __dllexport static Thread* thread();
 
@@ -359,9 +512,21 @@ namespace embree
     std::exception_ptr cancellingException;
     MutexSys mutex;
     ConditionSys condition;
+    size_t maxThreads;              //!< maximal number of threads including the root thread, 0 for no limit
+    int priority;                   //!< threads of the thread pool join schedulers of higher priority first
+
+    /* parking of idle threads */
+    std::atomic<size_t> numParkedThreads; //!< number of threads waiting for new tasks
+    size_t wakeupCounter;                 //!< incremented for each wakeup, protected by idleMutex
+    MutexSys idleMutex;
+    ConditionSys idleCondition;
 
   private:
     static size_t g_numThreads;
+    static ssize_t g_idleSpinTime;
+    static External g_external;
+    static std::atomic<bool> g_hasExternal;
+    static __thread ssize_t g_externalThreadIndex;
     static __thread TaskScheduler* g_instance;
     static __thread Thread* thread_local_thread;
     static ThreadPool* threadPool;
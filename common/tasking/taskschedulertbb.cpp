@@ -31,8 +31,9 @@ namespace embree
     
   } tbb_affinity;
   
-  void TaskScheduler::create(size_t numThreads, bool set_affinity, bool start_threads)
+  void TaskScheduler::create(size_t numThreads, bool set_affinity, bool start_threads, ssize_t idle_spin_time)
   {
+    /* TBB manages idle worker threads itself, thus idle_spin_time is ignored */
     assert(numThreads);
 
     /* first terminate threads in case we configured them */
@@ -36,7 +36,7 @@ namespace embree
   struct TaskScheduler
   {
     /*! initializes the task scheduler */
-    static void create(size_t numThreads, bool set_affinity, bool start_threads);
+    static void create(size_t numThreads, bool set_affinity, bool start_threads, ssize_t idle_spin_time = -1);
 
     /*! destroys the task scheduler again */
     static void destroy();
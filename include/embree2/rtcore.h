@@ -262,6 +262,64 @@ RTCORE_API RTCORE_DEPRECATED void rtcDeviceSetMemoryMonitorFunction(RTCDevice de
  *  function. */
 RTCORE_API void rtcDeviceSetMemoryMonitorFunction2(RTCDevice device, RTCMemoryMonitorFunc2 func, void* userPtr);
 
+/*! \brief Type of the function that allocates bytes of memory aligned
+ *  to align bytes, where align is a power of two. */
+typedef void* (*RTCAlignedMallocFunc)(void* userPtr, size_t bytes, size_t align);
+
+/*! \brief Type of the function that frees memory allocated with the
+ *  aligned allocation function. */
+typedef void (*RTCAlignedFreeFunc)(void* userPtr, void* ptr);
+
+/*! \brief Type of the function that allocates a large block of
+ *  bytes of memory, where bytes is a multiple of the page size. The
+ *  function has to return memory aligned to at least 4KB and sets
+ *  *hugePages if the block is backed by 2MB pages. */
+typedef void* (*RTCPageMallocFunc)(void* userPtr, size_t bytes, bool* hugePages);
+
+/*! \brief Type of the function that frees a block allocated with the
+ *  page allocation function. */
+typedef void (*RTCPageFreeFunc)(void* userPtr, void* ptr, size_t bytes, bool hugePages);
+
+/*! \brief Memory allocation functions of the application. An
+ *  allocation and the corresponding free function have to get set
+ *  together, functions that are NULL use the allocator of Embree. */
+struct RTCAllocatorFunctions
+{
+  RTCAlignedMallocFunc alignedMalloc;  //!< allocates general memory, e.g. for BVH nodes, primitive arrays, and buffers
+  RTCAlignedFreeFunc alignedFree;      //!< frees memory of alignedMalloc
+  RTCPageMallocFunc pageMalloc;        //!< allocates large page granular blocks, e.g. for BVHs of static scenes and the tessellation cache
+  RTCPageFreeFunc pageFree;            //!< frees memory of pageMalloc
+};
+
+/*! \brief Lets the device allocate all memory of its scenes through
+ *  the allocation functions of the application. The userPtr pointer
+ *  is passed to each invokation of these functions. Passing NULL
+ *  restores the allocator of Embree. The functions cannot change
+ *  while the scenes of the device have memory allocated, thus should
+ *  get set before creating the first scene. */
+RTCORE_API void rtcDeviceSetAllocatorFunctions(RTCDevice device, const RTCAllocatorFunctions* functions, void* userPtr);
+
+/*! \brief Type of the task function of a task set of Embree. The
+ *  threadIndex is the index (0..numThreads-1) of the thread of the
+ *  application's tasking system that executes the task. */
+typedef void (*RTCTaskFunc)(void* taskPtr, size_t threadIndex, size_t taskIndex);
+
+/*! \brief Type of the parallel for function of the application's
+ *  tasking system. The function has to invoke func(taskPtr,
+ *  threadIndex, taskIndex) for each taskIndex in [0,taskCount) and
+ *  return after all invocations finished. The function gets called
+ *  recursively from inside these task functions. */
+typedef void (*RTCParallelForFunc)(void* userPtr, RTCTaskFunc func, void* taskPtr, size_t taskCount);
+
+/*! \brief Lets Embree execute all its parallel work through the
+ *  parallel for function of the application's tasking system which
+ *  uses numThreads threads, instead of starting its own threads. The
+ *  setting applies to all devices, passing NULL as function switches
+ *  back to the tasking system of Embree. The function must not get
+ *  called while some build is running and is only supported when
+ *  Embree got compiled with its internal tasking system. */
+RTCORE_API void rtcDeviceSetParallelForFunction(RTCDevice device, RTCParallelForFunc func, void* userPtr, size_t numThreads);
+
 /*! \brief Implementation specific.
 
   This function is implementation specific and only for debugging
@@ -123,6 +123,14 @@ typedef void (*RTCFilterFuncN)(int* valid,                            /*!< point
                                const struct RTCHitN* potentialHit,          /*!< potential new hit */
                                const size_t N                         /*!< size of ray packet */);
 
+/*! Batched intersection filter function for single rays. */
+typedef void (*RTCFilterFuncBatch)(int* valid,                            /*!< pointer to valid mask */
+                                   void* userPtr,                         /*!< pointer to geometry user data */
+                                   const RTCIntersectContext* context,    /*!< intersection context as passed to rtcIntersect/rtcOccluded */
+                                   const RTCRay& ray,                     /*!< ray and previous hit */
+                                   const struct RTCHitN* potentialHits,   /*!< potential new hits sorted by distance */
+                                   const size_t N                         /*!< number of potential hits */);
+
 /*! Displacement mapping function.
 
   WARNING: This callback is deprecated, use RTCDisplacementFunc2 instead.
@@ -587,6 +595,10 @@ RTCORE_API void rtcSetTessellationRate (RTCScene scene, unsigned geomID, float t
 /*! \brief Sets 32 bit ray mask. */
 RTCORE_API void rtcSetMask (RTCScene scene, unsigned geomID, int mask);
 
+/*! \brief Enables or disables culling of back facing hits for a
+ *  triangle or quad mesh. */
+RTCORE_API void rtcSetBackfaceCulling (RTCScene scene, unsigned geomID, bool enable);
+
 /*! \brief Sets boundary interpolation mode for default subdivision surface topology.
   WARNING: This function is deprecated, use rtcSetSubdivisionMode instead.
  */
@@ -642,6 +654,49 @@ RTCORE_API void rtcSetBuffer(RTCScene scene, unsigned geomID, RTCBufferType type
 RTCORE_API void rtcSetBuffer2(RTCScene scene, unsigned geomID, RTCBufferType type, 
                               const void* ptr, size_t byteOffset, size_t byteStride, size_t size = -1);
 
+/*! \brief Types of geometries that can get created with rtcNewGeometries. */
+enum RTCGeometryType
+{
+  RTC_GEOMETRY_TYPE_TRIANGLE_MESH = 0,  //!< triangle meshes
+  RTC_GEOMETRY_TYPE_QUAD_MESH     = 1,  //!< quad meshes
+  RTC_GEOMETRY_TYPE_LINE_SEGMENTS = 2,  //!< line segments
+};
+
+/*! \brief Describes a data buffer shared with Embree, see rtcSetBuffer2. */
+struct RTCBufferDescriptor
+{
+  RTCBufferType type;   //!< type of the buffer
+  const void* ptr;      //!< pointer to the buffer data
+  size_t byteOffset;    //!< byte offset to the first element
+  size_t byteStride;    //!< byte stride of the elements
+  size_t size;          //!< number of elements, or -1 to keep the size of the geometry
+};
+
+/*! \brief Describes a geometry created by rtcNewGeometries. */
+struct RTCGeometryDescriptor
+{
+  RTCGeometryFlags flags;                //!< geometry flags
+  size_t numPrimitives;                  //!< number of triangles, quads, or line segments
+  size_t numVertices;                    //!< number of vertices
+  size_t numTimeSteps;                   //!< number of motion blur time steps
+  const RTCBufferDescriptor* buffers;    //!< buffers to share with Embree
+  size_t numBuffers;                     //!< number of buffers to share
+};
+
+/*! \brief Creates many geometries of the same type at once. Each
+ *  descriptor specifies the size of one geometry like the
+ *  rtcNewTriangleMesh, rtcNewQuadMesh, and rtcNewLineSegments
+ *  functions, and optionally an array of buffers that get shared with
+ *  Embree like with rtcSetBuffer2. The geometries get created in
+ *  parallel and get assigned the consecutive geometry IDs starting at
+ *  the returned ID. If some geometry cannot get created, no geometry
+ *  gets created and RTC_INVALID_GEOMETRY_ID is returned. */
+RTCORE_API unsigned rtcNewGeometries(RTCScene scene,                              //!< the scene the geometries belong to
+                                     RTCGeometryType type,                        //!< type of all geometries
+                                     const RTCGeometryDescriptor* geometries,     //!< descriptors of the geometries
+                                     size_t numGeometries                         //!< number of geometries to create
+  );
+
 /*! \brief Enable geometry. Enabled geometry can be hit by a ray. */
 RTCORE_API void rtcEnable (RTCScene scene, unsigned geomID);
 
@@ -689,6 +744,9 @@ RTCORE_API void rtcSetIntersectionFilterFunction16 (RTCScene scene, unsigned geo
 /*! \brief Sets the intersection filter function for ray packets of size N. */
 RTCORE_API void rtcSetIntersectionFilterFunctionN (RTCScene scene, unsigned geomID, RTCFilterFuncN func);
 
+/*! \brief Sets the batched intersection filter function for single rays. */
+RTCORE_API void rtcSetIntersectionFilterFunctionBatch (RTCScene scene, unsigned geomID, RTCFilterFuncBatch func);
+
 /*! \brief Sets the occlusion filter function for single rays. */
 RTCORE_API void rtcSetOcclusionFilterFunction (RTCScene scene, unsigned geomID, RTCFilterFunc func);
 
@@ -704,6 +762,9 @@ RTCORE_API void rtcSetOcclusionFilterFunction16 (RTCScene scene, unsigned geomID
 /*! \brief Sets the occlusion filter function for ray packets of size N. */
 RTCORE_API void rtcSetOcclusionFilterFunctionN (RTCScene scene, unsigned geomID, RTCFilterFuncN func);
 
+/*! \brief Sets the batched occlusion filter function for single rays. */
+RTCORE_API void rtcSetOcclusionFilterFunctionBatch (RTCScene scene, unsigned geomID, RTCFilterFuncBatch func);
+
 /*! Set pointer for user defined data per geometry. Invokations
  *  of the various user intersect and occluded functions get passed
  *  this data pointer when called. */
@@ -87,6 +87,22 @@ RTCORE_DEPRECATED typedef RTCProgressMonitorFunc RTC_PROGRESS_MONITOR_FUNCTION;
 /*! \brief Sets the progress callback function which is called during hierarchy build of this scene. */
 RTCORE_API void rtcSetProgressMonitorFunction(RTCScene scene, RTCProgressMonitorFunc func, void* ptr);
 
+/*! \brief Priorities of the hierarchy build of a scene. */
+enum RTCBuildPriority
+{
+  RTC_BUILD_PRIORITY_LOW    = 0,   //!< worker threads join other builds first
+  RTC_BUILD_PRIORITY_NORMAL = 1,   //!< default priority
+  RTC_BUILD_PRIORITY_HIGH   = 2,   //!< worker threads join this build first
+};
+
+/*! \brief Limits the number of threads used for the hierarchy build of
+ *  this scene and sets the priority of the build. The number of
+ *  threads includes the thread calling rtcCommit, a value of 0 uses
+ *  all threads of the device. Using fewer threads lets builds run
+ *  concurrently to rendering in other threads with a predictable
+ *  latency. */
+RTCORE_API void rtcSetBuildThreads(RTCScene scene, size_t numThreads, RTCBuildPriority priority);
+
 /*! Commits the geometry of the scene. After initializing or modifying
  *  geometries, commit has to get called before tracing
  *  rays. */
@@ -18,11 +18,14 @@
 
 #define MBLUR_NUM_TEMPORAL_BINS 2
 #define MBLUR_NUM_OBJECT_BINS   32
+#define MBLUR_NUM_SPATIAL_BINS  8
 
 #include "../bvh/bvh.h"
 #include "../common/primref_mb.h"
 #include "heuristic_binning_array_aligned.h"
 #include "heuristic_timesplit_array.h"
+#include "heuristic_spatial_array_mb.h"
+#include "splitter.h"
 
 namespace embree
 {
@@ -151,6 +154,10 @@ namespace embree
         __noinline LBBox3fa linearBounds(const PrimRefMB& prim, const BBox1f time_range, const LinearSpace3fa& space) const {
           return scene->get<Mesh>(prim.geomID())->linearBounds(space, prim.primID(), time_range);
         }
+
+        __forceinline LBBox3fa linearBounds(const PrimRefMB& prim, const BBox1f time_range, const BBox3fa& region) const {
+          return clippedLinearBounds(scene->get<Mesh>(prim.geomID()), prim.primID(), time_range, region);
+        }
       };
 
     struct BVHBuilderMSMBlur
@@ -162,7 +169,7 @@ namespace embree
         Settings ()
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(8),
           travCost(1.0f), intCost(1.0f), singleLeafTimeSegment(false),
-          singleThreadThreshold(1024) {}
+          spatialSplits(false), singleThreadThreshold(1024) {}
 
       public:
         size_t branchingFactor;  //!< branching factor of BVH to build
@@ -173,6 +180,7 @@ namespace embree
         float travCost;          //!< estimated cost of one traversal step
         float intCost;           //!< estimated cost of one primitive intersection
         bool singleLeafTimeSegment; //!< split time to single time range
+        bool spatialSplits;      //!< enables spatial splits of primitives
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
       };
 
@@ -182,10 +190,10 @@ namespace embree
 	__forceinline BuildRecord () {}
 
         __forceinline BuildRecord (size_t depth)
-          : depth(depth) {}
+          : depth(depth), clipBounds(full) {}
 
-        __forceinline BuildRecord (const SetMB& prims, const BinSplit<MBLUR_NUM_OBJECT_BINS>& split, size_t depth)
-          : depth(depth), prims(prims), split(split) {}
+        __forceinline BuildRecord (const SetMB& prims, const BinSplit<MBLUR_NUM_OBJECT_BINS>& split, size_t depth, const BBox3fa& clipBounds = full)
+          : depth(depth), prims(prims), split(split), clipBounds(clipBounds) {}
 
         __forceinline friend bool operator< (const BuildRecord& a, const BuildRecord& b) {
           return a.prims.size() < b.prims.size();
@@ -199,6 +207,7 @@ namespace embree
 	size_t depth;                     //!< Depth of the root of this subtree.
 	SetMB prims;                      //!< The list of primitives.
         BinSplit<MBLUR_NUM_OBJECT_BINS> split;  //!< The best split for the primitives.
+        BBox3fa clipBounds;               //!< Region the primitives got restricted to by spatial splits.
       };
 
       template<
@@ -237,6 +246,7 @@ namespace embree
             : Settings(settings),
             heuristicObjectSplit(),
             heuristicTemporalSplit(device, recalculatePrimRef),
+            heuristicSpatialSplit(device, recalculatePrimRef),
             recalculatePrimRef(recalculatePrimRef), createAlloc(createAlloc), createNode(createNode), setNode(setNode), createLeaf(createLeaf),
             progressMonitor(progressMonitor)
           {
@@ -245,7 +255,7 @@ namespace embree
           }
 
           /*! finds the best split */
-          const Split find(const SetMB& set)
+          const Split find(const SetMB& set, const BBox3fa& clipBounds)
           {
             /* first try standard object split */
             const Split object_split = heuristicObjectSplit.find(set,logBlockSize);
@@ -253,26 +263,38 @@ namespace embree
 
             /* test temporal splits only when object split was bad */
             const float leaf_sah = set.leafSAH(logBlockSize);
-            if (object_split_sah < 0.50f*leaf_sah)
+            const bool bad_object_split = object_split_sah >= 0.50f*leaf_sah;
+            if (!bad_object_split && !spatialSplits)
               return object_split;
 
+            Split best_split = object_split;
+
             /* do temporal splits only if the the time range is big enough */
-            if (set.time_range.size() > 1.01f/float(set.max_num_time_segments))
+            if (bad_object_split && set.time_range.size() > 1.01f/float(set.max_num_time_segments))
             {
               const Split temporal_split = heuristicTemporalSplit.find(set,logBlockSize);
-              const float temporal_split_sah = temporal_split.splitSAH();
 
               /* take temporal split if it improved SAH */
-              if (temporal_split_sah < object_split_sah)
-                return temporal_split;
+              if (temporal_split.splitSAH() < best_split.splitSAH())
+                best_split = temporal_split;
             }
 
-            return object_split;
+            /* spatial splits also help when the object split overlaps a lot but is not bad */
+            if (spatialSplits)
+            {
+              const Split spatial_split = heuristicSpatialSplit.find(set,clipBounds,logBlockSize);
+              if (spatial_split.splitSAH() < best_split.splitSAH())
+                best_split = spatial_split;
+            }
+
+            return best_split;
           }
 
           /*! array partitioning */
           __forceinline std::unique_ptr<mvector<PrimRefMB>> split(const BuildRecord& brecord, BuildRecord& lrecord, BuildRecord& rrecord)
           {
+            lrecord.clipBounds = rrecord.clipBounds = brecord.clipBounds;
+
             /* perform object split */
             if (likely(brecord.split.data == Split::SPLIT_OBJECT)) {
               heuristicObjectSplit.split(brecord.split,brecord.prims,lrecord.prims,rrecord.prims);
@@ -281,6 +303,10 @@ namespace embree
             else if (likely(brecord.split.data == Split::SPLIT_TEMPORAL)) {
               return heuristicTemporalSplit.split(brecord.split,brecord.prims,lrecord.prims,rrecord.prims);
             }
+            /* perform spatial split */
+            else if (brecord.split.data == Split::SPLIT_SPATIAL) {
+              return heuristicSpatialSplit.split(brecord.split,brecord.prims,brecord.clipBounds,lrecord.prims,rrecord.prims,lrecord.clipBounds,rrecord.clipBounds);
+            }
             /* perform fallback split */
             else if (unlikely(brecord.split.data == Split::SPLIT_FALLBACK)) {
               brecord.prims.deterministic_order();
@@ -338,6 +364,13 @@ namespace embree
             new (&rset) SetMB(rinfo,set.prims,range<size_t>(center,end  ),set.time_range);
           }
 
+          /*! calculates the linear bounds of the primitives clipped to the region spatial splits restricted them to */
+          __forceinline LBBox3fa linearBounds(const BuildRecord& current) const
+          {
+            if (likely(!spatialSplits)) return current.prims.linearBounds(recalculatePrimRef);
+            return current.prims.linearBounds(recalculatePrimRef,current.clipBounds);
+          }
+
           const NodeRecordMB4D createLargeLeaf(const BuildRecord& in, Allocator alloc)
           {
             /* this should never occur but is a fatal error */
@@ -345,11 +378,15 @@ namespace embree
               throw_RTCError(RTC_UNKNOWN_ERROR,"depth limit reached");
 
             /* replace already found split by fallback split */
-            const BuildRecord current(in.prims,findFallback(in.prims),in.depth);
+            const BuildRecord current(in.prims,findFallback(in.prims),in.depth,in.clipBounds);
 
             /* create leaf for few primitives */
             if (current.size() <= maxLeafSize && current.split.data != Split::SPLIT_TEMPORAL)
-              return createLeaf(current,alloc);
+            {
+              NodeRecordMB4D leaf = createLeaf(current,alloc);
+              if (unlikely(spatialSplits)) leaf.lbounds = linearBounds(current);
+              return leaf;
+            }
 
             /* fill all children by always splitting the largest one */
             bool hasTimeSplits = false;
@@ -378,8 +415,8 @@ namespace embree
               BuildRecord& brecord = children[bestChild];
               BuildRecord lrecord(current.depth+1);
               BuildRecord rrecord(current.depth+1);
+              hasTimeSplits |= brecord.split.data == Split::SPLIT_TEMPORAL;
               std::unique_ptr<mvector<PrimRefMB>> new_vector = split(brecord,lrecord,rrecord);
-              hasTimeSplits |= new_vector != nullptr;
 
               /* find new splits */
               lrecord.split = findFallback(lrecord.prims);
@@ -401,7 +438,7 @@ namespace embree
 
             /* calculate geometry bounds of this node */
             if (hasTimeSplits)
-              return NodeRecordMB4D(node,current.prims.linearBounds(recalculatePrimRef),current.prims.time_range);
+              return NodeRecordMB4D(node,linearBounds(current),current.prims.time_range);
             else
               return NodeRecordMB4D(node,gbounds,current.prims.time_range);
           }
@@ -450,12 +487,12 @@ namespace embree
               BuildRecord& brecord = children[bestChild];
               BuildRecord lrecord(current.depth+1);
               BuildRecord rrecord(current.depth+1);
+              hasTimeSplits |= brecord.split.data == Split::SPLIT_TEMPORAL;
               std::unique_ptr<mvector<PrimRefMB>> new_vector = split(brecord,lrecord,rrecord);
-              hasTimeSplits |= new_vector != nullptr;
 
               /* find new splits */
-              lrecord.split = find(lrecord.prims);
-              rrecord.split = find(rrecord.prims);
+              lrecord.split = find(lrecord.prims,lrecord.clipBounds);
+              rrecord.split = find(rrecord.prims,rrecord.clipBounds);
               children.split(bestChild,lrecord,rrecord,std::move(new_vector));
 
             } while (children.size() < branchingFactor);
@@ -496,7 +533,7 @@ namespace embree
 
             /* calculate geometry bounds of this node */
             if (unlikely(hasTimeSplits))
-              return NodeRecordMB4D(node,current.prims.linearBounds(recalculatePrimRef),current.prims.time_range);
+              return NodeRecordMB4D(node,linearBounds(current),current.prims.time_range);
             else
               return NodeRecordMB4D(node,gbounds,current.prims.time_range);
           }
@@ -505,7 +542,8 @@ namespace embree
           __forceinline const NodeRecordMB4D operator() (mvector<PrimRefMB>& prims, const PrimInfoMB& pinfo)
           {
             const SetMB set(pinfo,&prims);
-            auto ret = recurse(BuildRecord(set,find(set),1),nullptr,true);
+            heuristicSpatialSplit.reset(pinfo.size());
+            auto ret = recurse(BuildRecord(set,find(set,full),1),nullptr,true);
             _mm_mfence(); // to allow non-temporal stores during build
             return ret;
           }
@@ -513,6 +551,7 @@ namespace embree
         private:
           HeuristicArrayBinningMB<PrimRefMB,MBLUR_NUM_OBJECT_BINS> heuristicObjectSplit;
           HeuristicMBlurTemporalSplit<PrimRefMB,RecalculatePrimRef,MBLUR_NUM_TEMPORAL_BINS> heuristicTemporalSplit;
+          HeuristicMBlurSpatialSplit<PrimRefMB,RecalculatePrimRef,MBLUR_NUM_SPATIAL_BINS> heuristicSpatialSplit;
           const RecalculatePrimRef recalculatePrimRef;
           const CreateAllocFunc createAlloc;
           const CreateNodeFunc createNode;
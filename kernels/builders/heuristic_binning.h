@@ -123,6 +123,25 @@ namespace embree
         size_t num;
         vfloat4 ofs,scale;        //!< linear function that maps to bin ID
       };
+
+    /*! returns a bit mask of the N primitives that are left of the split
+     *  position, four primitives at a time get binned in the split
+     *  dimension only */
+    template<size_t N, typename BinMapping, typename PrimRef>
+      __forceinline size_t binLeftMask(const BinMapping& mapping, const PrimRef* prims, const size_t dim, const vint4& vSplitPos)
+    {
+      const vfloat4 ofs(mapping.ofs[dim]);
+      const vfloat4 scale(mapping.scale[dim]);
+      size_t mask = 0;
+      for (size_t i=0; i<N; i+=4)
+      {
+        const vfloat4 lower(prims[i+0].lower[dim],prims[i+1].lower[dim],prims[i+2].lower[dim],prims[i+3].lower[dim]);
+        const vfloat4 upper(prims[i+0].upper[dim],prims[i+1].upper[dim],prims[i+2].upper[dim],prims[i+3].upper[dim]);
+        const vint4 bin = floori((lower+upper-ofs)*scale);
+        mask |= size_t(movemask(bin < vSplitPos)) << i;
+      }
+      return mask;
+    }
     
     /*! stores all information to perform some split */
     template<size_t BINS>
@@ -133,6 +152,7 @@ namespace embree
           SPLIT_OBJECT   =  0,
           SPLIT_TEMPORAL = -1,
           SPLIT_FALLBACK = -2,
+          SPLIT_SPATIAL  = -3,
         };
 
         /*! construct an invalid split by default */
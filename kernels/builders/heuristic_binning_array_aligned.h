@@ -116,16 +116,20 @@ namespace embree
           const typename Binner::vbool vSplitMask(splitDimMask);
           auto isLeft = [&] (const PrimRef &ref) { return split.mapping.bin_unsafe(ref,vSplitPos,vSplitMask); };
 
+          /* classifies entire blocks of primitives with SIMD compares */
+          const vint4 vSplitPos4(splitPos);
+          auto isLeftBlock = [&] (const PrimRef* refs) { return binLeftMask<SERIAL_PARTITION_BLOCK_SIZE>(split.mapping,refs,splitDim,vSplitPos4); };
+
           size_t center = 0;
           if (!parallel)
-            center = serial_partitioning(prims,begin,end,local_left,local_right,isLeft,
+            center = serial_partitioning(prims,begin,end,local_left,local_right,isLeft,isLeftBlock,
                                          [] (CentGeomBBox3fa& pinfo,const PrimRef& ref) { pinfo.extend(ref.bounds()); });          
           else
             center = parallel_partitioning(
-              prims,begin,end,EmptyTy(),local_left,local_right,isLeft,
+              prims,begin,end,EmptyTy(),local_left,local_right,isLeft,isLeftBlock,
               [] (CentGeomBBox3fa& pinfo,const PrimRef &ref) { pinfo.extend(ref.bounds()); },
               [] (CentGeomBBox3fa& pinfo0,const CentGeomBBox3fa &pinfo1) { pinfo0.merge(pinfo1); },
-              PARALLEL_PARTITION_BLOCK_SIZE);
+              PARALLEL_PARTITION_BLOCK_SIZE,0);
           
           new (&lset) PrimInfoRange(begin,center,local_left.geomBounds,local_left.centBounds);
           new (&rset) PrimInfoRange(center,end,local_right.geomBounds,local_right.centBounds);
@@ -0,0 +1,275 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "../common/primref_mb.h"
+
+#define MBLUR_SPATIAL_SPLIT_THRESHOLD 1.10f
+#define MBLUR_SPATIAL_SPLIT_REPLICATION 0.5f
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Performs spatial splits of motion blurred primitives. A
+     *  primitive that lies on both sides of the split plane gets
+     *  referenced on both sides. The region a subtree covers is
+     *  tracked as a clip box, and the primitives of the subtree are
+     *  clipped against that region when calculating their linear
+     *  bounds. */
+    template<typename PrimRefMB, typename RecalculatePrimRef, size_t BINS>
+      struct HeuristicMBlurSpatialSplit
+      {
+        typedef BinSplit<MBLUR_NUM_OBJECT_BINS> Split;
+        typedef mvector<PrimRefMB>* PrimRefVector;
+        typedef typename PrimRefMB::BBox BBox;
+
+        static const size_t PARALLEL_THRESHOLD = 3 * 1024;
+        static const size_t PARALLEL_FIND_BLOCK_SIZE = 1024;
+
+        HeuristicMBlurSpatialSplit (MemoryMonitorInterface* device, const RecalculatePrimRef& recalculatePrimRef)
+          : device(device), recalculatePrimRef(recalculatePrimRef), replications(0) {}
+
+        enum Side { LEFT = 1, RIGHT = 2, BOTH = 3 };
+
+        /*! calculates on which side of the split plane a primitive lies
+         *  and the linear bounds of the parts on each side */
+        static __forceinline Side classify(const RecalculatePrimRef& recalculatePrimRef, const PrimRefMB& prim, BBox1f time_range, 
+                                           const BBox3fa& region, const LBBox3fa& bounds, size_t dim, float pos, 
+                                           LBBox3fa& lbounds, LBBox3fa& rbounds)
+        {
+          if (bounds.bounds0.upper[dim] <= pos && bounds.bounds1.upper[dim] <= pos) {
+            lbounds = bounds; return LEFT;
+          }
+          if (bounds.bounds0.lower[dim] >= pos && bounds.bounds1.lower[dim] >= pos) {
+            rbounds = bounds; return RIGHT;
+          }
+          lbounds = recalculatePrimRef.linearBounds(prim,time_range,leftRegion (region,dim,pos));
+          rbounds = recalculatePrimRef.linearBounds(prim,time_range,rightRegion(region,dim,pos));
+          if (rbounds.empty()) { lbounds = bounds; return LEFT; }
+          if (lbounds.empty()) { rbounds = bounds; return RIGHT; }
+          return BOTH;
+        }
+
+        static __forceinline BBox3fa leftRegion(const BBox3fa& region, size_t dim, float pos) {
+          BBox3fa r = region; r.upper[dim] = min(r.upper[dim],pos); return r;
+        }
+
+        static __forceinline BBox3fa rightRegion(const BBox3fa& region, size_t dim, float pos) {
+          BBox3fa r = region; r.lower[dim] = max(r.lower[dim],pos); return r;
+        }
+
+        static __forceinline float splitPosition(const BBox3fa& domain, size_t dim, size_t b) {
+          return lerp(domain.lower[dim],domain.upper[dim],float(b+1)/float(BINS));
+        }
+
+        static __forceinline BBox binBounds(const LBBox3fa& lbounds)
+        {
+#if MBLUR_BIN_LBBOX
+          return lbounds;
+#else
+          return lbounds.interpolate(0.5f);
+#endif
+        }
+
+        struct SpatialBinInfo
+        {
+          __forceinline SpatialBinInfo () {
+          }
+
+          __forceinline SpatialBinInfo (EmptyTy)
+          {
+            for (size_t dim=0; dim<3; dim++)
+            {
+              for (size_t i=0; i<BINS-1; i++)
+              {
+                lcount[dim][i] = rcount[dim][i] = 0;
+                lbounds[dim][i] = rbounds[dim][i] = empty;
+              }
+            }
+          }
+
+          void bin(const PrimRefMB* prims, size_t begin, size_t end, BBox1f time_range, const BBox3fa& domain, const BBox3fa& region, const RecalculatePrimRef& recalculatePrimRef)
+          {
+            for (size_t i=begin; i<end; i++)
+            {
+              const LBBox3fa bn = recalculatePrimRef.linearBounds(prims[i],time_range,region);
+              const size_t num = prims[i].size();
+
+              for (size_t dim=0; dim<3; dim++)
+              {
+                for (size_t b=0; b<BINS-1; b++)
+                {
+                  LBBox3fa lbn, rbn;
+                  const Side side = classify(recalculatePrimRef,prims[i],time_range,region,bn,dim,splitPosition(domain,dim,b),lbn,rbn);
+                  if (side & LEFT ) { lbounds[dim][b].extend(binBounds(lbn)); lcount[dim][b] += num; }
+                  if (side & RIGHT) { rbounds[dim][b].extend(binBounds(rbn)); rcount[dim][b] += num; }
+                }
+              }
+            }
+          }
+
+          __forceinline void bin_parallel(const PrimRefMB* prims, size_t begin, size_t end, size_t blockSize, size_t parallelThreshold, BBox1f time_range, const BBox3fa& domain, const BBox3fa& region, const RecalculatePrimRef& recalculatePrimRef)
+          {
+            if (likely(end-begin < parallelThreshold)) {
+              bin(prims,begin,end,time_range,domain,region,recalculatePrimRef);
+            }
+            else
+            {
+              auto bin = [&](const range<size_t>& r) -> SpatialBinInfo {
+                SpatialBinInfo binner(empty); binner.bin(prims, r.begin(), r.end(), time_range, domain, region, recalculatePrimRef); return binner;
+              };
+              *this = parallel_reduce(begin,end,blockSize,SpatialBinInfo(empty),bin,merge2);
+            }
+          }
+
+          /*! merges in other binning information */
+          __forceinline void merge (const SpatialBinInfo& other)
+          {
+            for (size_t dim=0; dim<3; dim++)
+            {
+              for (size_t i=0; i<BINS-1; i++)
+              {
+                lcount[dim][i] += other.lcount[dim][i];
+                rcount[dim][i] += other.rcount[dim][i];
+                lbounds[dim][i].extend(other.lbounds[dim][i]);
+                rbounds[dim][i].extend(other.rbounds[dim][i]);
+              }
+            }
+          }
+
+          static __forceinline const SpatialBinInfo merge2(const SpatialBinInfo& a, const SpatialBinInfo& b) {
+            SpatialBinInfo r = a; r.merge(b); return r;
+          }
+
+          Split best(int logBlockSize, BBox1f time_range, const BBox3fa& domain)
+          {
+            float bestSAH = inf;
+            int bestDim = -1;
+            float bestPos = 0.0f;
+            for (size_t dim=0; dim<3; dim++)
+            {
+              if (domain.lower[dim] >= domain.upper[dim]) continue;
+
+              for (size_t b=0; b<BINS-1; b++)
+              {
+                /* splits that replicate all primitives still shrink the bounds,
+                   the replication budget guarantees termination in that case */
+                if (lcount[dim][b] == 0 || rcount[dim][b] == 0) continue;
+
+                /* calculate sah */
+                const size_t lCount = (lcount[dim][b]+(1 << logBlockSize)-1) >> int(logBlockSize);
+                const size_t rCount = (rcount[dim][b]+(1 << logBlockSize)-1) >> int(logBlockSize);
+                const float sah = (expectedApproxHalfArea(lbounds[dim][b])*float(lCount) + expectedApproxHalfArea(rbounds[dim][b])*float(rCount))*time_range.size();
+                if (sah < bestSAH) {
+                  bestSAH = sah;
+                  bestDim = int(dim);
+                  bestPos = splitPosition(domain,dim,b);
+                }
+              }
+            }
+            if (bestDim == -1) return Split();
+            return Split(bestSAH*MBLUR_SPATIAL_SPLIT_THRESHOLD,(unsigned)Split::SPLIT_SPATIAL,bestDim,bestPos);
+          }
+
+        public:
+          size_t lcount[3][BINS-1];
+          size_t rcount[3][BINS-1];
+          BBox lbounds[3][BINS-1];
+          BBox rbounds[3][BINS-1];
+        };
+
+        /*! resets the number of primitive references spatial splits may create */
+        __forceinline void reset(size_t numPrimitives) {
+          replications = ssize_t(MBLUR_SPATIAL_SPLIT_REPLICATION*float(numPrimitives));
+        }
+
+        /*! finds the best split */
+        const Split find(const SetMB& set, const BBox3fa& region, const size_t logBlockSize)
+        {
+          assert(set.object_range.size() > 0);
+          if (replications <= 0) return Split();
+#if MBLUR_BIN_LBBOX
+          const BBox3fa domain = intersect(set.geomBounds.bounds(),region);
+#else
+          const BBox3fa domain = intersect(set.geomBounds,region);
+#endif
+          SpatialBinInfo binner(empty);
+          binner.bin_parallel(set.prims->data(),set.object_range.begin(),set.object_range.end(),PARALLEL_FIND_BLOCK_SIZE,PARALLEL_THRESHOLD,set.time_range,domain,region,recalculatePrimRef);
+          return binner.best(logBlockSize,set.time_range,domain);
+        }
+
+        /*! splits the primitives, the left side is returned in a new
+         *  vector and the right side gets compacted in place */
+        std::unique_ptr<mvector<PrimRefMB>> split(const Split& ssplit, const SetMB& set, const BBox3fa& region, SetMB& lset, SetMB& rset, BBox3fa& lregion, BBox3fa& rregion)
+        {
+          const size_t dim = ssplit.dim;
+          const float pos = ssplit.fpos;
+          mvector<PrimRefMB>& prims = *set.prims;
+          const size_t begin = set.object_range.begin();
+          const size_t end   = set.object_range.end();
+
+          /* count primitives of left side */
+          size_t numLeft = 0, numReplicated = 0;
+          for (size_t i=begin; i<end; i++)
+          {
+            LBBox3fa lbn, rbn;
+            const LBBox3fa bn = recalculatePrimRef.linearBounds(prims[i],set.time_range,region);
+            const Side side = classify(recalculatePrimRef,prims[i],set.time_range,region,bn,dim,pos,lbn,rbn);
+            numLeft += (side & LEFT) != 0;
+            numReplicated += side == BOTH;
+          }
+          replications -= numReplicated;
+
+          std::unique_ptr<mvector<PrimRefMB>> new_vector(new mvector<PrimRefMB>(device, numLeft));
+          mvector<PrimRefMB>& lprims = *new_vector.get();
+
+          /* distribute primitives, the right side never overtakes the read position */
+          PrimInfoMB linfo = empty;
+          PrimInfoMB rinfo = empty;
+          size_t l = 0, r = begin;
+          for (size_t i=begin; i<end; i++)
+          {
+            LBBox3fa lbn, rbn;
+            const PrimRefMB prim = prims[i];
+            const LBBox3fa bn = recalculatePrimRef.linearBounds(prim,set.time_range,region);
+            const Side side = classify(recalculatePrimRef,prim,set.time_range,region,bn,dim,pos,lbn,rbn);
+            if (side & LEFT) {
+              lprims[l] = PrimRefMB(lbn,prim.size(),prim.totalTimeSegments(),prim.geomID(),prim.primID());
+              linfo.add_primref(lprims[l++]);
+            }
+            if (side & RIGHT) {
+              prims[r] = PrimRefMB(rbn,prim.size(),prim.totalTimeSegments(),prim.geomID(),prim.primID());
+              rinfo.add_primref(prims[r++]);
+            }
+          }
+          assert(l == numLeft);
+
+          lset = SetMB(linfo,new_vector.get(),set.time_range);
+          rset = SetMB(rinfo,&prims,range<size_t>(begin,r),set.time_range);
+          lregion = leftRegion (region,dim,pos);
+          rregion = rightRegion(region,dim,pos);
+          return new_vector;
+        }
+
+      private:
+        MemoryMonitorInterface* device;              // device to report memory usage to
+        const RecalculatePrimRef recalculatePrimRef;
+        std::atomic<ssize_t> replications;           // number of primitive references spatial splits may still create
+      };
+  }
+}
@@ -158,6 +158,109 @@ namespace embree
       return pinfo;
     }
 
+    template<typename Mesh>
+    PrimRefChunks createPrimRefChunks(Scene* scene, size_t maxChunkSize, BuildProgressMonitor& progressMonitor)
+    {
+      Scene::Iterator<Mesh,false> iter(scene);
+      PrimRefChunks chunks;
+
+      /* compute centroid bounds */
+      progressMonitor(0);
+      const BBox3fa centBounds = parallel_for_for_reduce( iter, size_t(1024), BBox3fa(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k) -> BBox3fa
+      {
+        BBox3fa cbounds = empty;
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!mesh->buildBounds(j,&bounds)) continue;
+          cbounds.extend(center2(bounds));
+        }
+        return cbounds;
+      }, [](const BBox3fa& a, const BBox3fa& b) -> BBox3fa { return merge(a,b); });
+
+      const Vec3fa diag = max(Vec3fa(zero),centBounds.size());
+      chunks.dim = maxDim(diag);
+      chunks.ofs = centBounds.lower[chunks.dim];
+      chunks.scale = diag[chunks.dim] > 0.0f ? 0.99f*float(PrimRefChunks::BINS)/diag[chunks.dim] : 0.0f;
+
+      /* count primitives per bin */
+      std::vector<atomic<size_t>> bins(size_t(PrimRefChunks::BINS),atomic<size_t>(0));
+      parallel_for_for( iter, size_t(1024), [&](Mesh* mesh, const range<size_t>& r, size_t k)
+      {
+        size_t counts[PrimRefChunks::BINS];
+        for (size_t i=0; i<PrimRefChunks::BINS; i++) counts[i] = 0;
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!mesh->buildBounds(j,&bounds)) continue;
+          counts[chunks.bin(bounds)]++;
+        }
+        for (size_t i=0; i<PrimRefChunks::BINS; i++)
+          if (counts[i]) bins[i] += counts[i];
+      });
+
+      /* group consecutive bins into chunks, a single bin might exceed the chunk size */
+      size_t count = 0;
+      chunks.begin.push_back(0);
+      for (size_t i=0; i<PrimRefChunks::BINS; i++)
+      {
+        const size_t n = bins[i];
+        if (count > 0 && count+n > maxChunkSize) {
+          chunks.begin.push_back(i);
+          chunks.count.push_back(count);
+          count = 0;
+        }
+        count += n;
+      }
+      chunks.begin.push_back(size_t(PrimRefChunks::BINS));
+      chunks.count.push_back(count);
+      return chunks;
+    }
+
+    template<typename Mesh>
+    PrimInfo createPrimRefArrayChunk(Scene* scene, const PrimRefChunks& chunks, size_t chunkID, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
+    {
+      ParallelForForPrefixSumState<PrimInfo> pstate;
+      Scene::Iterator<Mesh,false> iter(scene);
+      const size_t bin0 = chunks.begin[chunkID+0];
+      const size_t bin1 = chunks.begin[chunkID+1];
+
+      /* count primitives of the chunk */
+      progressMonitor(0);
+      pstate.init(iter,size_t(1024));
+      parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k) -> PrimInfo
+      {
+        PrimInfo pinfo(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!mesh->buildBounds(j,&bounds)) continue;
+          const size_t bin = chunks.bin(bounds);
+          if (bin < bin0 || bin >= bin1) continue;
+          pinfo.add(bounds,bounds.center2());
+        }
+        return pinfo;
+      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+
+      /* store primitives of the chunk */
+      return parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
+      {
+        k = base.size();
+        PrimInfo pinfo(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!mesh->buildBounds(j,&bounds)) continue;
+          const size_t bin = chunks.bin(bounds);
+          if (bin < bin0 || bin >= bin1) continue;
+          const PrimRef prim(bounds,mesh->geomID,unsigned(j));
+          pinfo.add(bounds,bounds.center2());
+          prims[k++] = prim;
+        }
+        return pinfo;
+      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+    }
+
     template<typename Mesh>
     PrimInfo createPrimRefArrayMBlur(size_t timeSegment, Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
     {
@@ -339,6 +442,18 @@ namespace embree
     IF_ENABLED_USER(template PrimInfo createPrimRefArray<AccelSet COMMA false>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_USER(template PrimInfo createPrimRefArray<AccelSet COMMA true>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
 
+    IF_ENABLED_TRIS (template PrimRefChunks createPrimRefChunks<TriangleMesh>(Scene* scene COMMA size_t maxChunkSize COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_QUADS(template PrimRefChunks createPrimRefChunks<QuadMesh>(Scene* scene COMMA size_t maxChunkSize COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_HAIR (template PrimRefChunks createPrimRefChunks<NativeCurves>(Scene* scene COMMA size_t maxChunkSize COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_LINES(template PrimRefChunks createPrimRefChunks<LineSegments>(Scene* scene COMMA size_t maxChunkSize COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_USER (template PrimRefChunks createPrimRefChunks<AccelSet>(Scene* scene COMMA size_t maxChunkSize COMMA BuildProgressMonitor& progressMonitor));
+
+    IF_ENABLED_TRIS (template PrimInfo createPrimRefArrayChunk<TriangleMesh>(Scene* scene COMMA const PrimRefChunks& chunks COMMA size_t chunkID COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_QUADS(template PrimInfo createPrimRefArrayChunk<QuadMesh>(Scene* scene COMMA const PrimRefChunks& chunks COMMA size_t chunkID COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_HAIR (template PrimInfo createPrimRefArrayChunk<NativeCurves>(Scene* scene COMMA const PrimRefChunks& chunks COMMA size_t chunkID COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_LINES(template PrimInfo createPrimRefArrayChunk<LineSegments>(Scene* scene COMMA const PrimRefChunks& chunks COMMA size_t chunkID COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_USER (template PrimInfo createPrimRefArrayChunk<AccelSet>(Scene* scene COMMA const PrimRefChunks& chunks COMMA size_t chunkID COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
+
     IF_ENABLED_TRIS (template PrimInfo createPrimRefArrayMBlur<TriangleMesh>(size_t timeSegment COMMA Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_QUADS(template PrimInfo createPrimRefArrayMBlur<QuadMesh>(size_t timeSegment COMMA Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_LINES(template PrimInfo createPrimRefArrayMBlur<LineSegments>(size_t timeSegment COMMA Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
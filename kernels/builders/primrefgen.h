@@ -36,6 +36,40 @@ namespace embree
     template<typename Mesh, bool mblur>
       PrimInfo createPrimRefArray(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
+    /*! Partitions the primitives of a scene into spatially coherent
+     *  chunks of limited size. The primitives get binned by their
+     *  centroid along the largest dimension of the centroid bounds and
+     *  consecutive bins are grouped into chunks. */
+    struct PrimRefChunks
+    {
+      static const size_t BINS = 1024;
+
+      /*! returns the bin of a primitive */
+      __forceinline size_t bin(const BBox3fa& bounds) const
+      {
+        const int i = int((center2(bounds)[dim]-ofs)*scale);
+        return size_t(clamp(i,0,int(BINS)-1));
+      }
+
+      /*! returns the number of chunks */
+      __forceinline size_t size() const {
+        return count.size();
+      }
+
+    public:
+      int dim;                     //!< dimension the primitives get binned in
+      float ofs;                   //!< start of the binned range
+      float scale;                 //!< scale to map centroids to bins
+      std::vector<size_t> begin;   //!< first bin of each chunk, followed by BINS
+      std::vector<size_t> count;   //!< number of primitives of each chunk
+    };
+
+    template<typename Mesh>
+      PrimRefChunks createPrimRefChunks(Scene* scene, size_t maxChunkSize, BuildProgressMonitor& progressMonitor);
+
+    template<typename Mesh>
+      PrimInfo createPrimRefArrayChunk(Scene* scene, const PrimRefChunks& chunks, size_t chunkID, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+
     template<typename Mesh>
       PrimInfo createPrimRefArrayMBlur(size_t timeSegment, Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
@@ -92,6 +92,111 @@ namespace embree
       new (&right_o) PrimRef(intersect(right,prim.bounds()),prim.geomID(), prim.primID());
     }
     
+    /*! calculates the bounds of the polygon vj restricted to the part
+     *  where the same polygon at another time step vi lies below (or
+     *  above) the plane */
+    template<size_t N>
+    __forceinline BBox3fa clipPolygon(const Vec3fa (&vi)[N+1], 
+                                      const Vec3fa (&vj)[N+1],
+                                      const size_t dim, 
+                                      const float pos, 
+                                      const bool below)
+    {
+      BBox3fa bounds = empty;
+      for (size_t k=0; k<N; k++)
+      {
+        const float d0 = below ? pos-vi[k+0][dim] : vi[k+0][dim]-pos;
+        const float d1 = below ? pos-vi[k+1][dim] : vi[k+1][dim]-pos;
+        
+        if (d0 >= 0.0f) bounds.extend(vj[k]); // this point is inside
+        
+        if ((d0 < 0.0f && d1 > 0.0f) || (d1 < 0.0f && d0 > 0.0f)) // the edge crosses the plane
+          bounds.extend(lerp(vj[k],vj[k+1],d0/(d0-d1)));
+      }
+      return bounds;
+    }
+
+    /*! calculates conservative linear bounds of the part of a motion
+     *  blurred polygon that lies inside a region at any time of the
+     *  time range. A point of the polygon can only get inside some
+     *  half space if it is inside at one of the time steps, thus the
+     *  polygon is clipped at each time step against the half space at
+     *  all other time steps. */
+    template<size_t N, typename GetPolygon>
+    __forceinline LBBox3fa clipPolygonMB(const GetPolygon& getPolygon, const BBox1f& time_range, const float numTimeSegments, const BBox3fa& region)
+    {
+      const int ilower = (int)floor(time_range.lower*numTimeSegments);
+      const int iupper = (int)ceil (time_range.upper*numTimeSegments);
+      const int numSteps = iupper-ilower+1;
+      assert(numSteps <= RTC_MAX_TIME_STEPS);
+
+      Vec3fa v[RTC_MAX_TIME_STEPS][N+1];
+      BBox3fa bounds[RTC_MAX_TIME_STEPS];
+      for (int i=0; i<numSteps; i++) 
+      {
+        getPolygon(ilower+i,v[i]);
+        v[i][N] = v[i][0];
+        bounds[i] = empty;
+        for (size_t k=0; k<N; k++) bounds[i].extend(v[i][k]);
+      }
+
+      for (size_t dim=0; dim<3; dim++)
+      {
+        for (size_t side=0; side<2; side++)
+        {
+          const float pos = side ? region.upper[dim] : region.lower[dim];
+          if (pos == float(neg_inf) || pos == float(pos_inf)) continue;
+          
+          for (int j=0; j<numSteps; j++) 
+          {
+            BBox3fa b = empty;
+            for (int i=0; i<numSteps; i++) 
+              b.extend(clipPolygon<N>(v[i],v[j],dim,pos,side == 1));
+            bounds[j] = intersect(bounds[j],b);
+          }
+        }
+      }
+
+      /* the polygon never enters the region if it is outside at some time step */
+      for (int i=0; i<numSteps; i++)
+        if (bounds[i].empty()) return empty;
+
+      return LBBox3fa([&] (int itime) { return bounds[itime-ilower]; }, time_range, numTimeSegments);
+    }
+
+    /*! calculates the linear bounds of a primitive restricted to some region */
+    template<typename Mesh>
+    __forceinline LBBox3fa clippedLinearBounds(const Mesh* mesh, size_t primID, const BBox1f& time_range, const BBox3fa& region) {
+      return mesh->linearBounds(primID,time_range);
+    }
+
+    __forceinline LBBox3fa clippedLinearBounds(const TriangleMesh* mesh, size_t primID, const BBox1f& time_range, const BBox3fa& region)
+    {
+      const TriangleMesh::Triangle& tri = mesh->triangle(primID);
+      return clipPolygonMB<3>([&] (int itime, Vec3fa (&v)[4]) {
+          v[0] = mesh->vertex(tri.v[0],itime);
+          v[1] = mesh->vertex(tri.v[1],itime);
+          v[2] = mesh->vertex(tri.v[2],itime);
+        }, time_range, mesh->fnumTimeSegments, region);
+    }
+
+    __forceinline LBBox3fa clippedLinearBounds(const QuadMesh* mesh, size_t primID, const BBox1f& time_range, const BBox3fa& region)
+    {
+      /* quads are intersected as two triangles, thus we clip both triangles */
+      const QuadMesh::Quad& quad = mesh->quad(primID);
+      const LBBox3fa bounds0 = clipPolygonMB<3>([&] (int itime, Vec3fa (&v)[4]) {
+          v[0] = mesh->vertex(quad.v[0],itime);
+          v[1] = mesh->vertex(quad.v[1],itime);
+          v[2] = mesh->vertex(quad.v[3],itime);
+        }, time_range, mesh->fnumTimeSegments, region);
+      const LBBox3fa bounds1 = clipPolygonMB<3>([&] (int itime, Vec3fa (&v)[4]) {
+          v[0] = mesh->vertex(quad.v[2],itime);
+          v[1] = mesh->vertex(quad.v[3],itime);
+          v[2] = mesh->vertex(quad.v[1],itime);
+        }, time_range, mesh->fnumTimeSegments, region);
+      return merge(bounds0,bounds1);
+    }
+    
     struct TriangleSplitter
     {
       __forceinline TriangleSplitter(const Scene* scene, const PrimRef& prim)
@@ -16,6 +16,7 @@
 
 #include "bvh.h"
 #include "bvh_statistics.h"
+#include "../../common/algorithms/parallel_for.h"
 
 namespace embree
 {
@@ -25,6 +26,7 @@ namespace embree
       primTy(primTy), device(scene->device), scene(scene),
       root(emptyNode), alloc(scene->device,scene->isStatic()), numPrimitives(0), numVertices(0)
   {
+    alloc.setBlockPool(scene->block_pool.ptr);
   }
 
   template<int N>
@@ -120,6 +122,143 @@ namespace embree
     else return node;
   }
 
+  template<int N>
+  void BVHN<N>::compact(int layout)
+  {
+    if (layout == 0 || root == emptyNode)
+      return;
+
+    /* node or leaf together with the child slot of its parent node */
+    struct Item
+    {
+      __forceinline Item () {}
+      __forceinline Item (NodeRef ref, size_t parent, size_t slot)
+        : ref(ref), parent(parent), slot(slot) {}
+
+      NodeRef ref;
+      size_t parent;  //!< index of the parent item
+      size_t slot;    //!< child slot in the parent node
+    };
+
+    struct Layout
+    {
+      Layout (const PrimitiveType& primTy)
+        : primTy(primTy), valid(true) {}
+
+      /* returns the size of a node or leaf, or 0 for nodes that cannot get relocated */
+      size_t bytes(NodeRef ref) const
+      {
+        if (ref.isLeaf()) {
+          size_t num; ref.leaf(num);
+          return num*primTy.bytes;
+        }
+        switch (ref.type()) {
+        case tyAlignedNode    : return sizeof(AlignedNode);
+        case tyAlignedNodeMB  : return sizeof(AlignedNodeMB);
+        case tyAlignedNodeMB4D: return sizeof(AlignedNodeMB4D);
+        case tyUnalignedNode  : return sizeof(UnalignedNode);
+        case tyUnalignedNodeMB: return sizeof(UnalignedNodeMB);
+        default               : return 0; // quantized nodes store relative offsets, transform nodes reference other BVHs
+        }
+      }
+
+      /* appends a node or leaf to the layout, returns false if its children cannot get visited */
+      bool push(const Item& item)
+      {
+        if (bytes(item.ref) == 0) { valid = false; return false; }
+        order.push_back(item);
+        return !item.ref.isLeaf();
+      }
+
+      void depthFirst(const Item& item)
+      {
+        if (!push(item)) return;
+        const size_t index = order.size()-1;
+        BaseNode* node = item.ref.baseNode(BVH_FLAG_ALIGNED_NODE_MB);
+        for (size_t i=0; i<N; i++)
+          if (node->child(i) != emptyNode)
+            depthFirst(Item(node->child(i),index,i));
+      }
+
+      size_t height(NodeRef ref) const
+      {
+        if (ref.isLeaf() || bytes(ref) == 0) return 1;
+        size_t h = 0;
+        BaseNode* node = ref.baseNode(BVH_FLAG_ALIGNED_NODE_MB);
+        for (size_t i=0; i<N; i++)
+          if (node->child(i) != emptyNode)
+            h = max(h,height(node->child(i)));
+        return h+1;
+      }
+
+      /* lays out the top h levels of the subtree, the roots of the
+       * subtrees below get added to the frontier */
+      void vanEmdeBoas(const Item& item, size_t h, std::vector<Item>& frontier)
+      {
+        if (item.ref.isLeaf() || h == 1) 
+        {
+          if (!push(item)) return;
+          const size_t index = order.size()-1;
+          BaseNode* node = item.ref.baseNode(BVH_FLAG_ALIGNED_NODE_MB);
+          for (size_t i=0; i<N; i++)
+            if (node->child(i) != emptyNode)
+              frontier.push_back(Item(node->child(i),index,i));
+          return;
+        }
+
+        std::vector<Item> middle;
+        vanEmdeBoas(item,h/2,middle);
+        for (const Item& m : middle)
+          vanEmdeBoas(m,h-h/2,frontier);
+      }
+
+    public:
+      const PrimitiveType& primTy;
+      std::vector<Item> order;
+      bool valid;
+    };
+
+    /* determine the order of the nodes and leaves in memory */
+    Layout lay(primTy);
+    if (layout == 1) 
+      lay.depthFirst(Item(root,size_t(-1),0));
+    else {
+      std::vector<Item> frontier;
+      lay.vanEmdeBoas(Item(root,size_t(-1),0),lay.height(root),frontier);
+      assert(frontier.empty());
+    }
+    if (!lay.valid) return;
+
+    /* calculate tightly packed offsets, leaves keep the alignment of their primitives */
+    const std::vector<Item>& order = lay.order;
+    const size_t leafAlignment = max(size_t(byteAlignment),min(primTy.bytes & (~primTy.bytes+1),size_t(64)));
+    std::vector<size_t> offsets(order.size());
+    size_t bytes = 0;
+    for (size_t i=0; i<order.size(); i++) {
+      const size_t align = order[i].ref.isLeaf() ? leafAlignment : byteNodeAlignment;
+      bytes = (bytes+align-1) & ~(align-1);
+      offsets[i] = bytes;
+      bytes += lay.bytes(order[i].ref);
+    }
+
+    alloc.compact(bytes,[&] (char* ptr) 
+    {
+      parallel_for(size_t(0), order.size(), size_t(4096), [&] (const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++)
+          memcpy(ptr+offsets[i],(char*)(size_t(order[i].ref) & ~align_mask),lay.bytes(order[i].ref));
+      });
+
+      /* let the moved parents point to the moved children */
+      parallel_for(size_t(1), order.size(), size_t(4096), [&] (const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++) {
+          BaseNode* parent = (BaseNode*) (ptr+offsets[order[i].parent]);
+          parent->child(order[i].slot) = NodeRef((size_t)(ptr+offsets[i]) | (size_t(order[i].ref) & align_mask));
+        }
+      });
+      root = NodeRef((size_t)ptr | (size_t(root) & align_mask));
+    });
+  }
+
   template<int N>
   double BVHN<N>::preBuild(const std::string& builderName)
   {
@@ -460,8 +460,8 @@ namespace embree
 
       struct Set3
       {
-        Set3 (FastAllocator* allocator, PrimRef* prims)
-        : allocator(allocator), prims(prims) {}
+        Set3 (FastAllocator* allocator, PrimRef* prims, Scene* scene = nullptr)
+        : allocator(allocator), prims(prims), scene(scene) {}
 
         template<typename BuildRecord>
         __forceinline NodeRef operator() (const BuildRecord& precord, const BuildRecord* crecords, NodeRef ref, NodeRef* children, const size_t num) const
@@ -469,6 +469,14 @@ namespace embree
           AlignedNode* node = ref.alignedNode();
           for (size_t i=0; i<num; i++) node->setRef(i,children[i]);
 
+#if defined(EMBREE_RAY_MASK)
+          /* propagate geometry masks up the tree, only possible if primrefs reference scene geometries */
+          if (scene) {
+            for (size_t i=0; i<N; i++)
+              node->setMask(i, i<num ? childMask(crecords[i],children[i]) : 0);
+          }
+#endif
+
           if (unlikely(precord.alloc_barrier))
           {
             PrimRef* begin = &prims[precord.prims.begin()];
@@ -480,14 +488,33 @@ namespace embree
           return ref;
         }
 
+#if defined(EMBREE_RAY_MASK)
+        /*! calculates the mask of all geometries referenced by some child subtree */
+        template<typename BuildRecord>
+        __forceinline unsigned childMask(const BuildRecord& crecord, NodeRef child) const
+        {
+          if (child.isAlignedNode())
+            return child.alignedNode()->reduceMask();
+
+          unsigned mask = 0;
+          for (size_t i=crecord.prims.begin(); i<crecord.prims.end(); i++)
+            mask |= scene->get(prims[i].geomID())->mask;
+          return mask;
+        }
+#endif
+
         FastAllocator* const allocator;
         PrimRef* const prims;
+        Scene* const scene;
       };
 
       /*! Clears the node. */
       __forceinline void clear() {
         lower_x = lower_y = lower_z = pos_inf;
         upper_x = upper_y = upper_z = neg_inf;
+#if defined(EMBREE_RAY_MASK)
+        mask = -1;
+#endif
         BaseNode::clear();
       }
 
@@ -511,6 +538,22 @@ namespace embree
         children[i] = ref;
       }
 
+#if defined(EMBREE_RAY_MASK)
+      /*! Sets geometry mask of specified child. */
+      __forceinline void setMask(size_t i, unsigned m) {
+        assert(i < N);
+        mask[i] = m;
+      }
+
+      /*! Returns the geometry mask of all children. */
+      __forceinline unsigned reduceMask() const
+      {
+        unsigned m = 0;
+        for (size_t i=0; i<N; i++) m |= mask[i];
+        return m;
+      }
+#endif
+
       /*! Returns bounds of node. */
       __forceinline BBox3fa bounds() const {
         const Vec3fa lower(reduce_min(lower_x),reduce_min(lower_y),reduce_min(lower_z));
@@ -546,6 +589,9 @@ namespace embree
         std::swap(upper_x[i],upper_x[j]);
         std::swap(upper_y[i],upper_y[j]);
         std::swap(upper_z[i],upper_z[j]);
+#if defined(EMBREE_RAY_MASK)
+        std::swap(mask[i],mask[j]);
+#endif
       }
 
       /*! Returns reference to specified child */
@@ -562,6 +608,9 @@ namespace embree
         o << "  upper_y " << n.upper_y << std::endl;
         o << "  lower_z " << n.lower_z << std::endl;
         o << "  upper_z " << n.upper_z << std::endl;
+#if defined(EMBREE_RAY_MASK)
+        o << "  mask " << n.mask << std::endl;
+#endif
         o << "  children = ";
         for (size_t i=0; i<N; i++) o << n.children[i] << " ";
         o << std::endl;
@@ -576,6 +625,9 @@ namespace embree
       vfloat<N> upper_y;           //!< Y dimension of upper bounds of all N children.
       vfloat<N> lower_z;           //!< Z dimension of lower bounds of all N children.
       vfloat<N> upper_z;           //!< Z dimension of upper bounds of all N children.
+#if defined(EMBREE_RAY_MASK)
+      vint<N> mask;                //!< OR of the masks of all geometries below each of the N children.
+#endif
     };
 
     /*! Motion Blur AlignedNode */
@@ -1382,6 +1434,11 @@ namespace embree
     void layoutLargeNodes(size_t num);
     NodeRef layoutLargeNodesRecursion(NodeRef& node, const FastAllocator::CachedAllocator& allocator);
 
+    /*! moves all nodes and leaves into a single tightly sized block,
+     *  laid out in depth first (layout=1) or van Emde Boas (layout=2)
+     *  order */
+    void compact(int layout);
+
     /*! called by all builders before build starts */
     double preBuild(const std::string& builderName);
 
@@ -987,28 +987,32 @@ namespace embree
   {
     BVH4Factory* factory = mesh->scene->device->bvh4_factory.get();
     accel = new BVH4(Triangle4::type,mesh->scene);
-    builder = factory->BVH4Triangle4MeshBuilderMortonGeneral(accel,mesh,0);
+    if (mesh->getType() == Geometry::GROUP) builder = factory->BVH4Triangle4MeshBuilderSAH(accel,mesh,0);
+    else                                    builder = factory->BVH4Triangle4MeshBuilderMortonGeneral(accel,mesh,0);
   }
 
   void BVH4Factory::createTriangleMeshTriangle4vMorton(TriangleMesh* mesh, AccelData*& accel, Builder*& builder)
   {
     BVH4Factory* factory = mesh->scene->device->bvh4_factory.get();
     accel = new BVH4(Triangle4v::type,mesh->scene);
-    builder = factory->BVH4Triangle4vMeshBuilderMortonGeneral(accel,mesh,0);
+    if (mesh->getType() == Geometry::GROUP) builder = factory->BVH4Triangle4vMeshBuilderSAH(accel,mesh,0);
+    else                                    builder = factory->BVH4Triangle4vMeshBuilderMortonGeneral(accel,mesh,0);
   }
 
   void BVH4Factory::createTriangleMeshTriangle4iMorton(TriangleMesh* mesh, AccelData*& accel, Builder*& builder)
   {
     BVH4Factory* factory = mesh->scene->device->bvh4_factory.get();
     accel = new BVH4(Triangle4i::type,mesh->scene);
-    builder = factory->BVH4Triangle4iMeshBuilderMortonGeneral(accel,mesh,0);
+    if (mesh->getType() == Geometry::GROUP) builder = factory->BVH4Triangle4iMeshBuilderSAH(accel,mesh,0);
+    else                                    builder = factory->BVH4Triangle4iMeshBuilderMortonGeneral(accel,mesh,0);
   }
 
   void BVH4Factory::createQuadMeshQuad4vMorton(QuadMesh* mesh, AccelData*& accel, Builder*& builder)
   {
     BVH4Factory* factory = mesh->scene->device->bvh4_factory.get();
     accel = new BVH4(Quad4v::type,mesh->scene);
-    builder = factory->BVH4Quad4vMeshBuilderMortonGeneral(accel,mesh,0);
+    if (mesh->getType() == Geometry::GROUP) builder = factory->BVH4Quad4vMeshBuilderSAH(accel,mesh,0);
+    else                                    builder = factory->BVH4Quad4vMeshBuilderMortonGeneral(accel,mesh,0);
   }
 
   void BVH4Factory::createTriangleMeshTriangle4(TriangleMesh* mesh, AccelData*& accel, Builder*& builder)
@@ -1196,7 +1200,7 @@ namespace embree
       switch (bvariant) {
       case BuildVariant::STATIC      : builder = BVH4Triangle4SceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : builder = BVH4BuilderTwoLevelTriangleMeshSAH(accel,scene,&createTriangleMeshTriangle4); break;
-      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4SceneBuilderFastSpatialSAH(accel,scene,0); break;
+      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4SceneBuilderFastSpatialSAH(accel,scene,MODE_HIGH_QUALITY); break;
       }
     }
     else if (scene->device->tri_builder == "sah"         ) builder = BVH4Triangle4SceneBuilderSAH(accel,scene,0);
@@ -1224,7 +1228,7 @@ namespace embree
       switch (bvariant) {
       case BuildVariant::STATIC      : builder = BVH4Triangle4vSceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : builder = BVH4BuilderTwoLevelTriangleMeshSAH(accel,scene,&createTriangleMeshTriangle4v); break;
-      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4vSceneBuilderFastSpatialSAH(accel,scene,0); break;
+      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4vSceneBuilderFastSpatialSAH(accel,scene,MODE_HIGH_QUALITY); break;
       }
     }
     else if (scene->device->tri_builder == "sah"         ) builder = BVH4Triangle4vSceneBuilderSAH(accel,scene,0);
@@ -1252,7 +1256,7 @@ namespace embree
       switch (bvariant) {
       case BuildVariant::STATIC      : builder = BVH4Triangle4iSceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : builder = BVH4BuilderTwoLevelTriangleMeshSAH(accel,scene,&createTriangleMeshTriangle4i); break;
-      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4iSceneBuilderFastSpatialSAH(accel,scene,0); break;
+      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4iSceneBuilderFastSpatialSAH(accel,scene,MODE_HIGH_QUALITY); break;
       }
     }
     else if (scene->device->tri_builder == "sah"         ) builder = BVH4Triangle4iSceneBuilderSAH(accel,scene,0);
@@ -1281,7 +1285,7 @@ namespace embree
       switch (bvariant) {
       case BuildVariant::STATIC      : builder = BVH4Triangle4iMBSceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : assert(false); break; // FIXME: implement
-      case BuildVariant::HIGH_QUALITY: assert(false); break;
+      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4iMBSceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY); break;
       }
     }
     else  if (scene->device->tri_builder_mb == "internal_time_splits") builder = BVH4Triangle4iMBSceneBuilderSAH(accel,scene,0);
@@ -1306,7 +1310,7 @@ namespace embree
       switch (bvariant) {
       case BuildVariant::STATIC      : builder = BVH4Triangle4vMBSceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : assert(false); break; // FIXME: implement
-      case BuildVariant::HIGH_QUALITY: assert(false); break;
+      case BuildVariant::HIGH_QUALITY: builder = BVH4Triangle4vMBSceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY); break;
       }
     }
     else  if (scene->device->tri_builder_mb == "internal_time_splits") builder = BVH4Triangle4vMBSceneBuilderSAH(accel,scene,0);
@@ -1325,7 +1329,7 @@ namespace embree
       switch (bvariant) {
       case BuildVariant::STATIC      : builder = BVH4Quad4vSceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : builder = BVH4BuilderTwoLevelQuadMeshSAH(accel,scene,&createQuadMeshQuad4v); break;
-      case BuildVariant::HIGH_QUALITY: builder = BVH4Quad4vSceneBuilderFastSpatialSAH(accel,scene,0); break;
+      case BuildVariant::HIGH_QUALITY: builder = BVH4Quad4vSceneBuilderFastSpatialSAH(accel,scene,MODE_HIGH_QUALITY); break;
       }
     }
     else if (scene->device->quad_builder == "sah"              ) builder = BVH4Quad4vSceneBuilderSAH(accel,scene,0);
@@ -1366,7 +1370,7 @@ namespace embree
       switch (bvariant) {
       case BuildVariant::STATIC      : builder = BVH4Quad4iMBSceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : assert(false); break; // FIXME: implement
-      case BuildVariant::HIGH_QUALITY: assert(false); break;
+      case BuildVariant::HIGH_QUALITY: builder = BVH4Quad4iMBSceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY); break;
       }
     }
     else if (scene->device->quad_builder_mb == "sah") builder = BVH4Quad4iMBSceneBuilderSAH(accel,scene,0);
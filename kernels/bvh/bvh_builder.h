@@ -29,7 +29,7 @@ namespace embree
         typedef FastAllocator::CachedAllocator Allocator;
       
         struct BVHNBuilderV {
-          NodeRef build(FastAllocator* allocator, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings);
+          NodeRef build(FastAllocator* allocator, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings, Scene* scene);
           virtual NodeRef createLeaf (const range<size_t>& set, const Allocator& alloc) = 0;
         };
 
@@ -47,9 +47,10 @@ namespace embree
           CreateLeafFunc createLeafFunc;
         };
 
+        /*! if a scene is passed, the primrefs reference scene geometries and geometry masks are stored in the nodes */
         template<typename CreateLeafFunc>
-        static NodeRef build(FastAllocator* allocator, CreateLeafFunc createLeaf, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings) {
-          return BVHNBuilderT<CreateLeafFunc>(createLeaf).build(allocator,progress,prims,pinfo,settings);
+        static NodeRef build(FastAllocator* allocator, CreateLeafFunc createLeaf, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings, Scene* scene = nullptr) {
+          return BVHNBuilderT<CreateLeafFunc>(createLeaf).build(allocator,progress,prims,pinfo,settings,scene);
         }
       };
 
@@ -100,6 +100,7 @@ namespace embree
         if (scene->isStatic()) {
           prims.clear();
           bvh->shrink();
+          bvh->compact(bvh->device->bvh_compaction);
         }
         bvh->cleanup();
         bvh->postBuild(t0);
@@ -190,7 +191,10 @@ namespace embree
         //});
         
         /* clear temporary data for static geometry */
-        if (scene->isStatic()) bvh->shrink();
+        if (scene->isStatic()) {
+          bvh->shrink();
+          bvh->compact(bvh->device->bvh_compaction);
+        }
         bvh->cleanup();
         bvh->postBuild(t0);
       }
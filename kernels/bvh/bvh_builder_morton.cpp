@@ -444,6 +444,7 @@ namespace embree
         {
           morton.clear();
           bvh->shrink();
+          bvh->compact(bvh->device->bvh_compaction);
         }
         bvh->cleanup();
       }
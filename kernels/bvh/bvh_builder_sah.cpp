@@ -16,6 +16,7 @@
 
 #include "bvh.h"
 #include "bvh_builder.h"
+#include "bvh_restructure.h"
 #include "../builders/bvh_builder_msmblur.h"
 
 #include "../builders/primrefgen.h"
@@ -61,7 +62,8 @@ namespace embree
         size_t n = set.size();
         size_t items = Primitive::blocks(n);
         size_t start = set.begin();
-        Primitive* accel = (Primitive*) alloc.malloc1(items*sizeof(Primitive),BVH::byteAlignment);
+        /* 8-wide primitives require 32 byte alignment for their non-temporal stores */
+        Primitive* accel = (Primitive*) alloc.malloc1(items*sizeof(Primitive),max(BVH::byteAlignment,alignof(Primitive)));
         typename BVH::NodeRef node = BVH::encodeLeaf((char*)accel,items);
         for (size_t i=0; i<items; i++) {
           accel[i].fill(prims,start,set.end(),bvh->scene);
@@ -99,6 +101,49 @@ namespace embree
       PrimRef* prims;
     };
 
+    /*! Builds a BVH over the primitives of a scene in spatially
+     *  coherent chunks of at most about maxChunkSize primitives, such
+     *  that the primref array only has to hold the primitives of one
+     *  chunk, extended by the replications of the spatial split
+     *  builder. The BVHs of the chunks get merged under a top level
+     *  BVH. */
+    template<int N, typename Mesh, typename BuildChunkFunc>
+    typename BVHN<N>::NodeRef buildChunked(BVHN<N>* bvh, Scene* scene, mvector<PrimRef>& prims, size_t maxChunkSize, float replications, PrimInfo& pinfo, const BuildChunkFunc& buildChunk)
+    {
+      typedef typename BVHN<N>::NodeRef NodeRef;
+      const PrimRefChunks chunks = createPrimRefChunks<Mesh>(scene,maxChunkSize,bvh->scene->progressInterface);
+
+      size_t maxChunkPrimitives = 0;
+      for (size_t i=0; i<chunks.size(); i++)
+        maxChunkPrimitives = max(maxChunkPrimitives,chunks.count[i]);
+      const size_t numChunkPrimitives = max(maxChunkPrimitives,size_t(replications*maxChunkPrimitives));
+      prims.resize(numChunkPrimitives);
+
+      /* build BVH for each chunk */
+      std::vector<NodeRef> roots;
+      mvector<PrimRef> refs(scene->device,chunks.size());
+      PrimInfo rinfo(empty);
+      pinfo = PrimInfo(empty);
+      for (size_t i=0; i<chunks.size(); i++)
+      {
+        const PrimInfo cinfo = createPrimRefArrayChunk<Mesh>(scene,chunks,i,prims,bvh->scene->progressInterface);
+        if (cinfo.size() == 0) continue;
+        refs[roots.size()] = PrimRef(cinfo.geomBounds,0,unsigned(roots.size()));
+        rinfo.add(cinfo.geomBounds,center2(cinfo.geomBounds));
+        roots.push_back(buildChunk(cinfo,numChunkPrimitives));
+        pinfo.merge(cinfo);
+      }
+      if (roots.size() == 0)
+        return BVHN<N>::emptyNode;
+
+      /* build top level BVH over the chunks, the chunk BVHs form its leaves */
+      GeneralBVHBuilder::Settings settings(1,1,1,travCost,1.0f,DEFAULT_SINGLE_THREAD_THRESHOLD);
+      return BVHNBuilderVirtual<N>::build(&bvh->alloc,[&] (const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+          assert(set.size() == 1);
+          return roots[refs[set.begin()].primID()];
+        },bvh->scene->progressInterface,refs.data(),rinfo,settings);
+    }
+
     /************************************************************************************/
     /************************************************************************************/
     /************************************************************************************/
@@ -120,10 +165,10 @@ namespace embree
       BVHNBuilderSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize,
                       const size_t mode, bool primrefarrayalloc = false)
         : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device,0),
-          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD), primrefarrayalloc(primrefarrayalloc) {}
+          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, bvh->device->sah_costs.intCost(N,bvh->primTy.name,intCost), DEFAULT_SINGLE_THREAD_THRESHOLD), primrefarrayalloc(primrefarrayalloc) {}
 
       BVHNBuilderSAH (BVH* bvh, Mesh* mesh, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD), primrefarrayalloc(false) {}
+        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, bvh->device->sah_costs.intCost(N,bvh->primTy.name,intCost), DEFAULT_SINGLE_THREAD_THRESHOLD), primrefarrayalloc(false) {}
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
@@ -165,6 +210,7 @@ namespace embree
 	if (group->isStatic()) {
           prims.clear();
           bvh->shrink();
+          bvh->compact(bvh->device->bvh_compaction);
         }
 	bvh->cleanup();
       }
@@ -200,8 +246,12 @@ namespace embree
         profile(2,PROFILE_RUNS,numPrimitives,[&] (ProfileTimer& timer) {
 #endif
 
+            /* build in chunks if the primref array exceeds the build memory limit */
+            const size_t maxChunkSize = mesh ? 0 : scene->device->build_memory_limit/sizeof(PrimRef);
+            const bool chunked = maxChunkSize && numPrimitives > maxChunkSize;
+
             /* create primref array */
-            if (primrefarrayalloc) {
+            if (primrefarrayalloc && !chunked) {
               settings.primrefarrayalloc = numPrimitives/1000;
               if (settings.primrefarrayalloc < 1000)
                 settings.primrefarrayalloc = inf;
@@ -216,11 +266,26 @@ namespace embree
             const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numPrimitives)*sizeof(Primitive));
             bvh->alloc.init_estimate(node_bytes+leaf_bytes);
             settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
-            prims.resize(numPrimitives); 
+            PrimInfo pinfo(empty);
+            NodeRef root = BVH::emptyNode;
+            if (chunked)
+            {
+              root = buildChunked<N,Mesh>(bvh,scene,prims,maxChunkSize,1.0f,pinfo,[&] (const PrimInfo& cinfo, size_t numChunkPrimitives) -> NodeRef {
+                  return BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh,prims.data()),bvh->scene->progressInterface,prims.data(),cinfo,settings,scene);
+                });
+            }
+            else
+            {
+              prims.resize(numPrimitives); 
 
-            PrimInfo pinfo = mesh ?
-              createPrimRefArray<Mesh>  (mesh ,prims,bvh->scene->progressInterface) :
-              createPrimRefArray<Mesh,false>(scene,prims,bvh->scene->progressInterface);
+              pinfo = mesh ?
+                createPrimRefArray<Mesh>  (mesh ,prims,bvh->scene->progressInterface) :
+                createPrimRefArray<Mesh,false>(scene,prims,bvh->scene->progressInterface);
+
+              /* call BVH builder */
+              if (likely(pinfo.size() != 0))
+                root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh,prims.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings,mesh ? nullptr : scene);
+            }
 
             /* pinfo might has zero size due to invalid geometry */
             if (unlikely(pinfo.size() == 0))
@@ -230,8 +295,6 @@ namespace embree
               return;
             }
 
-            /* call BVH builder */
-            NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh,prims.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
             bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
 
@@ -251,6 +314,10 @@ namespace embree
           bvh->shrink();
           prims.clear();
         }
+
+        /* static geometries get moved into tightly sized memory, this also frees the shared primref array */
+        if (staticGeom)
+          bvh->compact(bvh->device->bvh_compaction);
 	bvh->cleanup();
         bvh->postBuild(t0);
       }
@@ -278,10 +345,10 @@ namespace embree
       GeneralBVHBuilder::Settings settings;
 
       BVHNBuilderSAHQuantized (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD) {}
+        : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, bvh->device->sah_costs.intCost(N,bvh->primTy.name,intCost), DEFAULT_SINGLE_THREAD_THRESHOLD) {}
 
       BVHNBuilderSAHQuantized (BVH* bvh, Mesh* mesh, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD) {}
+        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, bvh->device->sah_costs.intCost(N,bvh->primTy.name,intCost), DEFAULT_SINGLE_THREAD_THRESHOLD) {}
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
@@ -416,9 +483,11 @@ namespace embree
       const float intCost;
       const size_t minLeafSize;
       const size_t maxLeafSize;
+      const bool spatialSplits;
 
-      BVHNBuilderMBlurSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize)
-        : bvh(bvh), scene(scene), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks)) {}
+      BVHNBuilderMBlurSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode = 0)
+        : bvh(bvh), scene(scene), sahBlockSize(sahBlockSize), intCost(bvh->device->sah_costs.intCost(N,bvh->primTy.name,intCost)), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks)),
+        spatialSplits((mode & MODE_HIGH_QUALITY) != 0) {}
 
       void build()
       {
@@ -435,7 +504,8 @@ namespace embree
         const size_t numTimeSteps = scene->getNumTimeSteps<Mesh,true>();
         const size_t numTimeSegments = numTimeSteps-1; assert(numTimeSteps > 1);
 
-        if (numTimeSegments == 1)
+        /* spatial splits are only supported by the multi segment builder */
+        if (numTimeSegments == 1 && !spatialSplits)
           buildSingleSegment(numPrimitives);
         else
           buildMultiSegment(numPrimitives);
@@ -445,7 +515,10 @@ namespace embree
 #endif
 
 	/* clear temporary data for static geometry */
-        if (scene->isStatic()) bvh->shrink();
+        if (scene->isStatic()) {
+          bvh->shrink();
+          bvh->compact(bvh->device->bvh_compaction);
+        }
 	bvh->cleanup();
         bvh->postBuild(t0);
       }
@@ -502,6 +575,7 @@ namespace embree
         settings.travCost = travCost;
         settings.intCost = intCost;
         settings.singleLeafTimeSegment = Primitive::singleTimeSegment;
+        settings.spatialSplits = spatialSplits;
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
         
         /* build hierarchy */
@@ -538,14 +612,15 @@ namespace embree
       mvector<PrimRef> prims0;
       GeneralBVHBuilder::Settings settings;
       const float splitFactor;
+      const bool restructure;
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(scene), mesh(nullptr), prims0(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications) {}
+        : bvh(bvh), scene(scene), mesh(nullptr), prims0(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, bvh->device->sah_costs.intCost(N,bvh->primTy.name,intCost), DEFAULT_SINGLE_THREAD_THRESHOLD),
+          splitFactor(scene->device->max_spatial_split_replications), restructure((mode & MODE_HIGH_QUALITY) != 0) {}
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Mesh* mesh, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(nullptr), mesh(mesh), prims0(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications) {}
+        : bvh(bvh), scene(nullptr), mesh(mesh), prims0(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, bvh->device->sah_costs.intCost(N,bvh->primTy.name,intCost), DEFAULT_SINGLE_THREAD_THRESHOLD),
+          splitFactor(scene->device->max_spatial_split_replications), restructure((mode & MODE_HIGH_QUALITY) != 0) {}
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
@@ -567,39 +642,62 @@ namespace embree
 
         double t0 = bvh->preBuild(mesh ? "" : TOSTRING(isa) "::BVH" + toString(N) + "BuilderFastSpatialSAH");
 
-        /* create primref array */
-        const size_t numSplitPrimitives = max(numOriginalPrimitives,size_t(splitFactor*numOriginalPrimitives));
-        prims0.resize(numSplitPrimitives);
-        PrimInfo pinfo = mesh ?
-          createPrimRefArray<Mesh>  (mesh ,prims0,bvh->scene->progressInterface) :
-          createPrimRefArray<Mesh,false>(scene,prims0,bvh->scene->progressInterface);
-
-        Splitter splitter(scene);
-
         /* enable os_malloc for static scenes or dynamic scenes with static geometry */
         if (mesh == NULL || mesh->isStatic())
           bvh->alloc.setOSallocation(true);
 
-        const size_t node_bytes = pinfo.size()*sizeof(typename BVH::AlignedNode)/(4*N);
-        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(pinfo.size())*sizeof(Primitive));
+        const size_t node_bytes = numOriginalPrimitives*sizeof(typename BVH::AlignedNode)/(4*N);
+        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numOriginalPrimitives)*sizeof(Primitive));
         bvh->alloc.init_estimate(node_bytes+leaf_bytes);
-        settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+        settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numOriginalPrimitives,node_bytes+leaf_bytes);
 
         settings.branchingFactor = N;
         settings.maxDepth = BVH::maxBuildDepthLeaf;
 
-        NodeRef root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
-          typename BVH::CreateAlloc(bvh),
-          typename BVH::AlignedNode::Create2(),
-          typename BVH::AlignedNode::Set2(),
-          CreateLeaf<N,Primitive>(bvh,prims0.data()),
-          splitter,
-          bvh->scene->progressInterface,
-          prims0.data(),
-          numSplitPrimitives,
-          pinfo,settings);
+        Splitter splitter(scene);
+
+        auto buildSpatialSAH = [&] (const PrimInfo& pinfo, size_t numSplitPrimitives) -> NodeRef {
+          return BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
+            typename BVH::CreateAlloc(bvh),
+            typename BVH::AlignedNode::Create2(),
+            typename BVH::AlignedNode::Set3(&bvh->alloc,prims0.data(),mesh ? nullptr : scene),
+            CreateLeaf<N,Primitive>(bvh,prims0.data()),
+            splitter,
+            bvh->scene->progressInterface,
+            prims0.data(),
+            numSplitPrimitives,
+            pinfo,settings);
+        };
+
+        /* build in chunks if the primref array including the spatial split replications exceeds the build memory limit */
+        const float replications = max(1.0f,splitFactor);
+        const size_t maxChunkSize = mesh ? 0 : size_t(float(scene->device->build_memory_limit/sizeof(PrimRef))/replications);
+        const bool chunked = maxChunkSize && numOriginalPrimitives > maxChunkSize;
+
+        PrimInfo pinfo(empty);
+        NodeRef root = BVH::emptyNode;
+        if (chunked)
+        {
+          root = buildChunked<N,Mesh>(bvh,scene,prims0,maxChunkSize,replications,pinfo,buildSpatialSAH);
+        }
+        else
+        {
+          /* create primref array */
+          const size_t numSplitPrimitives = max(numOriginalPrimitives,size_t(splitFactor*numOriginalPrimitives));
+          prims0.resize(numSplitPrimitives);
+          pinfo = mesh ?
+            createPrimRefArray<Mesh>  (mesh ,prims0,bvh->scene->progressInterface) :
+            createPrimRefArray<Mesh,false>(scene,prims0,bvh->scene->progressInterface);
+
+          root = buildSpatialSAH(pinfo,numSplitPrimitives);
+        }
 
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+
+        /* optimize treelets for high quality builds */
+        if (restructure)
+          BVHNRestructure<N>(bvh).restructure();
+
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
 
 	/* clear temporary data for static geometry */
@@ -607,6 +705,7 @@ namespace embree
 	if (staticGeom) {
           prims0.clear();
           bvh->shrink();
+          bvh->compact(bvh->device->bvh_compaction);
         }
 	bvh->cleanup();
         bvh->postBuild(t0);
@@ -647,8 +746,8 @@ namespace embree
     Builder* BVH4Triangle4vSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,TriangleMesh,Triangle4v>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4Triangle4iSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,TriangleMesh,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode,true); }
 
-    Builder* BVH4Triangle4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,TriangleMesh,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf); }
-    Builder* BVH4Triangle4vMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,TriangleMesh,Triangle4vMB>((BVH4*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH4Triangle4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,TriangleMesh,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
+    Builder* BVH4Triangle4vMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,TriangleMesh,Triangle4vMB>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
 
     Builder* BVH4Triangle4SceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<4,TriangleMesh,Triangle4,TriangleSplitterFactory>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4Triangle4vSceneBuilderFastSpatialSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<4,TriangleMesh,Triangle4v,TriangleSplitterFactory>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
@@ -664,8 +763,8 @@ namespace embree
     Builder* BVH8Triangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,TriangleMesh,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Triangle4vSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,TriangleMesh,Triangle4v>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Triangle4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,TriangleMesh,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode,true); }
-    Builder* BVH8Triangle4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<8,TriangleMesh,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf); }
-    Builder* BVH8Triangle4vMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<8,TriangleMesh,Triangle4vMB>((BVH8*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH8Triangle4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<8,TriangleMesh,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
+    Builder* BVH8Triangle4vMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<8,TriangleMesh,Triangle4vMB>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
 
     Builder* BVH8QuantizedTriangle4iSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,TriangleMesh,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8QuantizedTriangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,TriangleMesh,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
@@ -673,6 +772,8 @@ namespace embree
     Builder* BVH8Triangle4SceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<8,TriangleMesh,Triangle4,TriangleSplitterFactory>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Triangle4vSceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<8,TriangleMesh,Triangle4v,TriangleSplitterFactory>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
 
+    Builder* BVH8Triangle8SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,TriangleMesh,Triangle8>((BVH8*)bvh,scene,8,1.0f,8,inf,mode); }
+
 #endif
 #endif
 
@@ -681,7 +782,7 @@ namespace embree
     Builder* BVH4Quad4iMeshBuilderSAH     (void* bvh, QuadMesh* mesh, size_t mode)     { return new BVHNBuilderSAH<4,QuadMesh,Quad4i>((BVH4*)bvh,mesh,4,1.0f,4,inf,mode); }
     Builder* BVH4Quad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,QuadMesh,Quad4v>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4Quad4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,QuadMesh,Quad4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode,true); }
-    Builder* BVH4Quad4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,QuadMesh,Quad4i>((BVH4*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH4Quad4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,QuadMesh,Quad4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4QuantizedQuad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<4,QuadMesh,Quad4v>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4QuantizedQuad4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<4,QuadMesh,Quad4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4Quad4vSceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<4,QuadMesh,Quad4v,QuadSplitterFactory>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
@@ -689,7 +790,7 @@ namespace embree
 #if defined(__AVX__)
     Builder* BVH8Quad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,QuadMesh,Quad4v>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Quad4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,QuadMesh,Quad4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode,true); }
-    Builder* BVH8Quad4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<8,QuadMesh,Quad4i>((BVH8*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH8Quad4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<8,QuadMesh,Quad4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8QuantizedQuad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,QuadMesh,Quad4v>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8QuantizedQuad4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,QuadMesh,Quad4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Quad4vMeshBuilderSAH     (void* bvh, QuadMesh* mesh, size_t mode)     { return new BVHNBuilderSAH<8,QuadMesh,Quad4v>((BVH8*)bvh,mesh,4,1.0f,4,inf,mode); }
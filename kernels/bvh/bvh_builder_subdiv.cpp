@@ -515,6 +515,11 @@ namespace embree
       __forceinline LBBox3fa linearBounds(const PrimRefMB& prim, const BBox1f time_range) const {
         return LBBox3fa([&] (size_t itime) { return bounds[prim.ID()+itime]; }, time_range, prim.totalTimeSegments());
       }
+
+      /* patches cannot get clipped, but spatial splits are never enabled for them */
+      __forceinline LBBox3fa linearBounds(const PrimRefMB& prim, const BBox1f time_range, const BBox3fa& region) const {
+        return linearBounds(prim,time_range);
+      }
     };
 
     template<int N>
@@ -17,6 +17,8 @@
 #include "bvh_builder_twolevel.h"
 #include "bvh_statistics.h"
 #include "../builders/bvh_builder_sah.h"
+#include "../builders/bvh_builder_morton.h"
+#include "../../common/algorithms/parallel_sort.h"
 #include "../common/scene_line_segments.h"
 #include "../common/scene_triangle_mesh.h"
 #include "../common/scene_quad_mesh.h"
@@ -30,19 +32,117 @@
 #define SPLIT_MEMORY_RESERVE_SCALE 2
 #define SPLIT_MIN_EXT_SPACE 1000
 
+/* maximal number of primitives of a BVH shared by small geometries */
+#define MERGE_MAX_PRIMITIVES 4096
+
 namespace embree
 {
   namespace isa
   {
     template<int N, typename Mesh>
     BVHNBuilderTwoLevel<N,Mesh>::BVHNBuilderTwoLevel (BVH* bvh, Scene* scene, const createMeshAccelTy createMeshAccel, const size_t singleThreadThreshold)
-      : bvh(bvh), objects(bvh->objects), scene(scene), createMeshAccel(createMeshAccel), refs(scene->device,0), prims(scene->device,0), singleThreadThreshold(singleThreadThreshold) {}
+      : bvh(bvh), objects(bvh->objects), scene(scene), createMeshAccel(createMeshAccel), refs(scene->device,0), prims(scene->device,0), singleThreadThreshold(singleThreadThreshold),
+        mergeThreshold(scene->device->twolevel_merge_threshold) {}
     
     template<int N, typename Mesh>
     BVHNBuilderTwoLevel<N,Mesh>::~BVHNBuilderTwoLevel ()
     {
       for (size_t i=0; i<builders.size(); i++) 
 	delete builders[i];
+
+      for (size_t i=0; i<mergedObjects.size(); i++)
+        delete mergedObjects[i].group;
+    }
+
+    template<int N, typename Mesh>
+    bool BVHNBuilderTwoLevel<N,Mesh>::isMergeable(Mesh* mesh) const {
+      return mesh->isEnabled() && mesh->numTimeSteps == 1 && mesh->size() < mergeThreshold;
+    }
+
+    template<int N, typename Mesh>
+    void BVHNBuilderTwoLevel<N,Mesh>::createMergedObjects(const std::vector<unsigned>& geomIDs)
+    {
+      deleteMergedObjects();
+
+      /* delete BVHs of geometries that got small */
+      for (size_t i=0; i<geomIDs.size(); i++) {
+        const unsigned geomID = geomIDs[i];
+        delete builders[geomID]; builders[geomID] = nullptr;
+        delete objects [geomID]; objects [geomID] = nullptr;
+        isMerged[geomID] = true;
+      }
+      mergedIDs = geomIDs;
+
+      const size_t numGeometries = geomIDs.size();
+      if (numGeometries == 0) return;
+
+      /* calculate bounds of all small geometries */
+      std::vector<BBox3fa> bounds(numGeometries);
+      const BBox3fa centBounds = parallel_reduce(size_t(0), numGeometries, BBox3fa(empty), [&] (const range<size_t>& r) -> BBox3fa
+      {
+        BBox3fa centBounds = empty;
+        for (size_t i=r.begin(); i<r.end(); i++)
+        {
+          Mesh* mesh = scene->getSafe<Mesh>(geomIDs[i]);
+          BBox3fa geomBounds = empty;
+          for (size_t j=0; j<mesh->size(); j++) {
+            BBox3fa primBounds = empty;
+            if (mesh->buildBounds(j,&primBounds)) geomBounds.extend(primBounds);
+          }
+          bounds[i] = geomBounds;
+          if (!geomBounds.empty()) centBounds.extend(center2(geomBounds));
+        }
+        return centBounds;
+      }, [] (const BBox3fa& a, const BBox3fa& b) { return merge(a,b); });
+
+      /* sort small geometries along a space filling curve */
+      const BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
+      mvector<BVHBuilderMorton::BuildPrim> morton(scene->device,numGeometries);
+      mvector<BVHBuilderMorton::BuildPrim> tmp(scene->device,numGeometries);
+      for (size_t i=0; i<numGeometries; i++) {
+        morton[i].code  = bounds[i].empty() ? 0 : mapping.code(bounds[i]);
+        morton[i].index = unsigned(i);
+      }
+      radix_sort_u32(morton.data(),tmp.data(),numGeometries);
+
+      /* cut the curve into shared BVHs of a limited number of primitives */
+      std::vector<Geometry*> geometries;
+      size_t numGroupPrimitives = 0;
+      for (size_t i=0; i<=numGeometries; i++)
+      {
+        Mesh* mesh = i < numGeometries ? scene->getSafe<Mesh>(geomIDs[morton[i].index]) : nullptr;
+        if (geometries.size() && (mesh == nullptr || numGroupPrimitives+mesh->size() > MERGE_MAX_PRIMITIVES))
+        {
+          MergedObject merged;
+          merged.geomID = geometries[0]->geomID;
+          merged.group = new GeometryGroup(scene,RTC_GEOMETRY_STATIC,geometries);
+          createMeshAccel((Mesh*)merged.group,(AccelData*&)objects[merged.geomID],builders[merged.geomID]);
+          mergedObjects.push_back(merged);
+          geometries.clear();
+          numGroupPrimitives = 0;
+        }
+        if (mesh) {
+          geometries.push_back(mesh);
+          numGroupPrimitives += mesh->size();
+        }
+      }
+    }
+
+    template<int N, typename Mesh>
+    void BVHNBuilderTwoLevel<N,Mesh>::deleteMergedObjects()
+    {
+      for (size_t i=0; i<mergedObjects.size(); i++)
+      {
+        const unsigned geomID = mergedObjects[i].geomID;
+        delete builders[geomID]; builders[geomID] = nullptr;
+        delete objects [geomID]; objects [geomID] = nullptr;
+        delete mergedObjects[i].group;
+      }
+      for (size_t i=0; i<mergedIDs.size(); i++)
+        isMerged[mergedIDs[i]] = false;
+
+      mergedObjects.clear();
+      mergedIDs.clear();
     }
 
     // ===========================================================================
@@ -85,7 +185,20 @@ namespace embree
       if (objects.size()  < num) objects.resize(num);
       if (builders.size() < num) builders.resize(num);
       if (refs.size()     < num) refs.resize(num);
+      if (isMerged.size() < num) isMerged.resize(num,false);
       nextRef.store(0);
+
+      /* regroup small geometries if the set of small geometries changed */
+      if (mergeThreshold)
+      {
+        std::vector<unsigned> geomIDs;
+        for (size_t objectID=0; objectID<num; objectID++) {
+          Mesh* mesh = scene->getSafe<Mesh>(objectID);
+          if (mesh && isMergeable(mesh)) geomIDs.push_back(unsigned(objectID));
+        }
+        if (geomIDs != mergedIDs)
+          createMergedObjects(geomIDs);
+      }
       
       /* create acceleration structures */
       parallel_for(size_t(0), num, [&] (const range<size_t>& r)
@@ -100,6 +213,10 @@ namespace embree
             assert(objectID < builders.size() && builders[objectID] == nullptr);
             continue;
           }
+
+          /* small meshes share BVHs */
+          if (isMerged[objectID])
+            continue;
           
           /* create BVH and builder for new meshes */
           if (objects[objectID] == nullptr)
@@ -114,7 +231,7 @@ namespace embree
         {
           /* ignore if no triangle mesh or not enabled */
           Mesh* mesh = scene->getSafe<Mesh>(objectID);
-          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1) 
+          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1 || isMerged[objectID]) 
             continue;
         
           BVH*     object  = objects [objectID]; assert(object);
@@ -136,6 +253,43 @@ namespace embree
         }
       });
 
+      /* parallel build of BVHs shared by small geometries */
+      parallel_for(size_t(0), mergedObjects.size(), [&] (const range<size_t>& r)
+      {
+        for (size_t i=r.begin(); i<r.end(); i++)
+        {
+          const MergedObject& merged = mergedObjects[i];
+          BVH*     object  = objects [merged.geomID]; assert(object);
+          Builder* builder = builders[merged.geomID]; assert(builder);
+
+          /* build shared BVH if it is new or some geometry got modified */
+          bool modified = object->root == BVH::emptyNode;
+          size_t numGroupPrimitives = 0;
+          for (size_t j=0; j<merged.group->size(); j++)
+          {
+            Geometry* geom = (*merged.group)[j];
+            modified |= geom->isModified();
+            numGroupPrimitives += geom->size();
+            if (geom->numPrimitivesChanged) {
+              merged.group->numPrimitivesChanged = true;
+              geom->numPrimitivesChanged = false;
+            }
+          }
+          if (modified)
+            builder->build();
+
+          /* create build primitive */
+          if (!object->getBounds().empty())
+          {
+#if ENABLE_DIRECT_SAH_MERGE_BUILDER
+            refs[nextRef++] = BVHNBuilderTwoLevel::BuildRef(object->getBounds(),object->root,merged.geomID,unsigned(numGroupPrimitives));
+#else
+            refs[nextRef++] = BVHNBuilderTwoLevel::BuildRef(object->getBounds(),object->root);
+#endif
+          }
+        }
+      });
+
 
 #if PROFILE
       double d0 = getSeconds();
@@ -150,8 +304,8 @@ namespace embree
         /* open all large nodes */
         refs.resize(nextRef);
 
-        /* this probably needs some more tuning */
-        const size_t extSize = max(max((size_t)SPLIT_MIN_EXT_SPACE,refs.size()*SPLIT_MEMORY_RESERVE_SCALE),size_t((float)numPrimitives / SPLIT_MEMORY_RESERVE_FACTOR));
+        /* this probably needs some more tuning, the BVHs of merged geometries get opened like separate BVHs */
+        const size_t extSize = max(max((size_t)SPLIT_MIN_EXT_SPACE,(refs.size()+mergedIDs.size())*SPLIT_MEMORY_RESERVE_SCALE),size_t((float)numPrimitives / SPLIT_MEMORY_RESERVE_FACTOR));
         //PRINT(extSize);
  
 #if !ENABLE_DIRECT_SAH_MERGE_BUILDER
@@ -269,6 +423,7 @@ namespace embree
     void BVHNBuilderTwoLevel<N,Mesh>::deleteGeometry(size_t geomID)
     {
       if (geomID >= objects.size()) return;
+      if (geomID < isMerged.size() && isMerged[geomID]) deleteMergedObjects();
       delete builders[geomID]; builders[geomID] = nullptr;
       delete objects [geomID]; objects [geomID] = nullptr;
     }
@@ -276,6 +431,8 @@ namespace embree
     template<int N, typename Mesh>
     void BVHNBuilderTwoLevel<N,Mesh>::clear()
     {
+      deleteMergedObjects();
+
       for (size_t i=0; i<objects.size(); i++) 
         if (objects[i]) objects[i]->clear();
 
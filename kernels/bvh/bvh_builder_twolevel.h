@@ -19,6 +19,7 @@
 #include "bvh.h"
 #include "../common/primref.h"
 #include "../builders/priminfo.h"
+#include "../common/scene_geometry_instance.h"
 
 namespace embree
 {
@@ -115,6 +116,17 @@ namespace embree
 
       void open_sequential(const size_t extSize);
 
+    private:
+
+      /*! checks if the geometry is small enough to share a BVH with other small geometries */
+      bool isMergeable(Mesh* mesh) const;
+
+      /*! groups the specified small geometries spatially into shared BVHs */
+      void createMergedObjects(const std::vector<unsigned>& geomIDs);
+
+      /*! deletes all shared BVHs of small geometries */
+      void deleteMergedObjects();
+
     public:
       BVH* bvh;
       std::vector<BVH*>& objects;
@@ -129,6 +141,19 @@ namespace embree
       std::atomic<int> nextRef;
       const size_t singleThreadThreshold;
 
+      /*! BVH shared by several small geometries, the BVH and its
+       *  builder get stored at the slot of the first geometry */
+      struct MergedObject
+      {
+        unsigned geomID;        //!< geometry ID of the slot of the shared BVH
+        GeometryGroup* group;   //!< geometries of the shared BVH
+      };
+
+      const size_t mergeThreshold;              //!< geometries with fewer primitives get merged
+      std::vector<MergedObject> mergedObjects;  //!< shared BVHs of small geometries
+      std::vector<unsigned> mergedIDs;          //!< sorted IDs of all merged geometries
+      std::vector<bool> isMerged;               //!< marks all merged geometries
+
       typedef mvector<BuildRef> bvector;
 
     };
@@ -92,6 +92,7 @@ namespace embree
           STAT3(normal.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N,Nx,types,robust>::intersect(cur,vray,ray_near,ray_far,ray.time,tNear,mask);
           if (unlikely(!nodeIntersected)) { STAT3(normal.trav_nodes,-1,-1,-1); break; }
+          mask = maskNode<N,types>(cur,ray.mask,mask);
 
           /*! if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -174,6 +175,7 @@ namespace embree
           STAT3(shadow.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N,Nx,types,robust>::intersect(cur,vray,ray_near,ray_far,ray.time,tNear,mask);
           if (unlikely(!nodeIntersected)) { STAT3(shadow.trav_nodes,-1,-1,-1); break; }
+          mask = maskNode<N,types>(cur,ray.mask,mask);
 
           /*! if no child is hit, pop next node */
           if (unlikely(mask == 0))
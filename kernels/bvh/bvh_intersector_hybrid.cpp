@@ -94,6 +94,7 @@ namespace embree
           size_t mask = 0;
           vfloat<Nx> tNear;
           BVHNNodeIntersector1<N,Nx,types,robust>::intersect(cur,vray,ray_near,ray_far,ray.time[k],tNear,mask);
+          mask = maskNode<N,types>(cur,ray.mask[k],mask);
 
           /*! if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -385,6 +386,7 @@ namespace embree
             size_t mask = 0;
             vfloat<Nx> tNear;
             BVHNNodeIntersector1<N,Nx,types,robust>::intersect(cur,vray,ray_near,ray_far,ray.time[k],tNear,mask);
+            mask = maskNode<N,types>(cur,ray.mask[k],mask);
 
             /*! if no child is hit, pop next node */
             if (unlikely(mask == 0))
@@ -1053,6 +1053,21 @@ namespace embree
       return lhit;
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////
+    // ray mask culling of BVHN::AlignedNode children
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    /*! Removes all children from the hit mask whose subtree contains no geometry visible to the ray mask. */
+    template<int N, int types>
+      __forceinline size_t maskNode(const typename BVHN<N>::NodeRef& node, const int rayMask, size_t mask)
+    {
+#if defined(EMBREE_RAY_MASK)
+      if ((types & BVH_FLAG_ALIGNED_NODE) && node.isAlignedNode())
+        mask &= movemask((node.alignedNode()->mask & vint<N>(rayMask)) != vint<N>(zero));
+#endif
+      return mask;
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////
     // Node intersectors used in ray traversal
     //////////////////////////////////////////////////////////////////////////////////////
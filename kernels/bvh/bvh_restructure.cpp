@@ -0,0 +1,268 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_restructure.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! checks if a subset of treelet leaves contains a single leaf */
+    __forceinline bool isSingleton(unsigned s) {
+      return (s & (s-1)) == 0;
+    }
+
+    template<int N>
+    BVHNRestructure<N>::BVHNRestructure (BVH* bvh)
+      : bvh(bvh) {}
+
+    template<int N>
+    void BVHNRestructure<N>::restructure() {
+      recurse(bvh->root,0);
+    }
+
+    template<int N>
+    void BVHNRestructure<N>::recurse(NodeRef ref, size_t depth)
+    {
+      if (!ref.isAlignedNode()) return;
+      AlignedNode* node = ref.alignedNode();
+
+      /* optimize children first, the top levels in parallel */
+      if (depth < PARALLEL_DEPTH)
+      {
+        parallel_for(size_t(0), size_t(N), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++)
+              recurse(node->child(i),depth+1);
+          });
+      }
+      else
+      {
+        for (size_t i=0; i<N; i++)
+          recurse(node->child(i),depth+1);
+      }
+
+      optimize(node,depth);
+    }
+
+    template<int N>
+    size_t BVHNRestructure<N>::height(NodeRef ref)
+    {
+      if (!ref.isAlignedNode()) return 0;
+      AlignedNode* node = ref.alignedNode();
+      size_t h = 0;
+      for (size_t i=0; i<N; i++)
+        h = max(h,height(node->child(i)));
+      return h+1;
+    }
+
+    template<int N>
+    void BVHNRestructure<N>::optimize(AlignedNode* root, size_t depth)
+    {
+      static const size_t MAX_SUBSETS = size_t(1) << MAX_TREELET_LEAVES;
+
+      TreeletLeaf leaves[MAX_TREELET_LEAVES];
+      size_t leafDepth[MAX_TREELET_LEAVES];
+      AlignedNode* nodes[MAX_TREELET_NODES];
+      size_t numLeaves = 0, numNodes = 0;
+
+      auto addChildren = [&] (AlignedNode* node, size_t d)
+      {
+        nodes[numNodes++] = node;
+        for (size_t i=0; i<N; i++)
+        {
+          if (node->child(i) == BVH::emptyNode) break;
+          TreeletLeaf& leaf = leaves[numLeaves];
+          leaf.ref = node->child(i);
+          leaf.bounds = node->bounds(i);
+#if defined(EMBREE_RAY_MASK)
+          leaf.mask = node->mask[i];
+#else
+          leaf.mask = -1;
+#endif
+          leafDepth[numLeaves++] = d;
+        }
+      };
+
+      /* form treelet by expanding the child with largest surface area */
+      float oldCost = 0.0f;
+      addChildren(root,1);
+      while (true)
+      {
+        ssize_t bestLeaf = -1;
+        float bestArea = neg_inf;
+        for (size_t i=0; i<numLeaves; i++)
+        {
+          if (!leaves[i].ref.isAlignedNode()) continue;
+          AlignedNode* node = leaves[i].ref.alignedNode();
+          size_t numChildren = 0;
+          while (numChildren < N && node->child(numChildren) != BVH::emptyNode) numChildren++;
+          if (numLeaves+numChildren-1 > MAX_TREELET_LEAVES) continue;
+          const float area = halfArea(leaves[i].bounds);
+          if (area > bestArea) { bestArea = area; bestLeaf = i; }
+        }
+        if (bestLeaf == -1) break;
+
+        AlignedNode* node = leaves[bestLeaf].ref.alignedNode();
+        const size_t d = leafDepth[bestLeaf];
+        oldCost += bestArea;
+        leaves[bestLeaf] = leaves[--numLeaves];
+        leafDepth[bestLeaf] = leafDepth[numLeaves];
+        addChildren(node,d+1);
+      }
+
+      /* nothing to restructure if the treelet consists of a single node */
+      if (numNodes == 1) return;
+
+      size_t oldHeight = 0;
+      for (size_t i=0; i<numLeaves; i++) {
+        leaves[i].height = height(leaves[i].ref);
+        oldHeight = max(oldHeight,leafDepth[i]+leaves[i].height);
+      }
+
+      /* calculate the optimal treelet for each subset s of leaves,
+       * cost[s] is the SAH cost of a node over s and groups[k][s] the
+       * cost of distributing s over at most k+1 subtrees */
+      const unsigned numSubsets = unsigned(1) << numLeaves;
+      BBox3fa bounds[MAX_SUBSETS];
+      unsigned mask[MAX_SUBSETS];
+      float cost[MAX_SUBSETS];
+      unsigned char nodeSplit[MAX_SUBSETS];
+      float groups[N-1][MAX_SUBSETS];
+      unsigned char groupSplit[N-1][MAX_SUBSETS];
+
+      auto subtreeCost = [&] (unsigned s) -> float {
+        return isSingleton(s) ? 0.0f : cost[s];
+      };
+
+      /* finds the best first subtree p of s when the remaining leaves
+       * are distributed with the specified costs, only subsets that
+       * contain the lowest leaf are enumerated to avoid duplicates */
+      auto bestSplit = [&] (unsigned s, const float* rest, float& bestCost) -> unsigned
+      {
+        const unsigned lowest = s & (0-s);
+        const unsigned others = s ^ lowest;
+        unsigned best = s;
+        for (unsigned q=others; ; q=(q-1) & others)
+        {
+          const unsigned p = q | lowest;
+          if (p != s) {
+            const float c = subtreeCost(p) + rest[s^p];
+            if (c < bestCost) { bestCost = c; best = p; }
+          }
+          if (q == 0) break;
+        }
+        return best;
+      };
+
+      bounds[0] = empty;
+      mask[0] = 0;
+      for (unsigned s=1; s<numSubsets; s++)
+      {
+        const unsigned lowest = s & (0-s);
+        const TreeletLeaf& leaf = leaves[__bsf(s)];
+        bounds[s] = merge(bounds[s^lowest],leaf.bounds);
+        mask[s] = mask[s^lowest] | leaf.mask;
+
+        if (isSingleton(s)) {
+          cost[s] = 0.0f; nodeSplit[s] = s;
+          for (size_t k=0; k<N-1; k++) { groups[k][s] = 0.0f; groupSplit[k][s] = s; }
+          continue;
+        }
+
+        /* a node has at least two and at most N children */
+        float nodeCost = inf;
+        nodeSplit[s] = bestSplit(s,groups[N-2],nodeCost);
+        cost[s] = halfArea(bounds[s]) + nodeCost;
+
+        groups[0][s] = cost[s]; groupSplit[0][s] = s;
+        for (size_t k=1; k<N-1; k++) {
+          groups[k][s] = cost[s];
+          groupSplit[k][s] = bestSplit(s,groups[k-1],groups[k][s]);
+        }
+      }
+
+      /* gets the subsets of leaves of the children of a node */
+      auto children = [&] (unsigned s, unsigned* child) -> size_t
+      {
+        size_t num = 0;
+        child[num++] = nodeSplit[s];
+        unsigned rest = s ^ nodeSplit[s];
+        for (size_t k=N-2; rest; k--) {
+          child[num++] = groupSplit[k][rest];
+          rest ^= groupSplit[k][rest];
+        }
+        return num;
+      };
+
+      /* the optimal treelet has to improve the SAH cost, has to fit
+       * into the available nodes, and must not make the BVH deeper
+       * than the builders would */
+      const unsigned all = numSubsets-1;
+      const float newCost = cost[all] - halfArea(bounds[all]);
+      if (!(newCost < oldCost)) return;
+
+      struct StackItem { unsigned s; size_t d; AlignedNode* node; };
+      StackItem stack[MAX_TREELET_NODES];
+      size_t stackPtr = 0, newNodes = 0, newHeight = 0;
+      stack[stackPtr++] = { all, 0, nullptr };
+      while (stackPtr)
+      {
+        const StackItem item = stack[--stackPtr];
+        newNodes++;
+        unsigned child[N];
+        const size_t num = children(item.s,child);
+        for (size_t i=0; i<num; i++) {
+          if (isSingleton(child[i])) newHeight = max(newHeight,item.d+1+leaves[__bsf(child[i])].height);
+          else if (newNodes+stackPtr < numNodes) stack[stackPtr++] = { child[i], item.d+1, nullptr };
+          else return;
+        }
+      }
+      if (depth+newHeight > max(depth+oldHeight,BVH::maxBuildDepthLeaf)) return;
+
+      /* write optimized treelet reusing the nodes of the original one */
+      size_t nextNode = 0;
+      stack[stackPtr++] = { all, 0, nodes[nextNode++] };
+      while (stackPtr)
+      {
+        const StackItem item = stack[--stackPtr];
+        AlignedNode* node = item.node;
+        node->clear();
+        unsigned child[N];
+        const size_t num = children(item.s,child);
+        for (size_t i=0; i<num; i++)
+        {
+          const unsigned s = child[i];
+          if (isSingleton(s)) {
+            node->set(i,leaves[__bsf(s)].ref,bounds[s]);
+          } else {
+            AlignedNode* c = nodes[nextNode++];
+            node->set(i,BVH::encodeNode(c),bounds[s]);
+            stack[stackPtr++] = { s, item.d+1, c };
+          }
+#if defined(EMBREE_RAY_MASK)
+          node->setMask(i,mask[s]);
+#endif
+        }
+      }
+    }
+
+    template class BVHNRestructure<4>;
+#if defined(__AVX__)
+    template class BVHNRestructure<8>;
+#endif
+  }
+}
@@ -0,0 +1,73 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Treelet restructuring of a BVH. Bottom-up each node gets
+     *  expanded into a treelet of a few subtrees, and the topology of
+     *  the treelet with the lowest SAH cost is calculated through
+     *  dynamic programming over all subsets of these subtrees. The
+     *  optimized treelet reuses the nodes of the original one. */
+    template<int N>
+    class BVHNRestructure
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AlignedNode AlignedNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+      static const size_t MAX_TREELET_LEAVES = 8;
+      static const size_t MAX_TREELET_NODES = MAX_TREELET_LEAVES-1;
+      static const size_t PARALLEL_DEPTH = (N==4) ? 4 : 3;
+
+    public:
+
+      /*! Constructor. */
+      BVHNRestructure (BVH* bvh);
+
+      /*! restructures all treelets of the BVH */
+      void restructure();
+
+    private:
+
+      /*! subtree the treelet is build over */
+      struct TreeletLeaf
+      {
+        NodeRef ref;
+        BBox3fa bounds;
+        unsigned mask;
+        size_t height;
+      };
+
+      /*! restructures the subtree bottom-up */
+      void recurse(NodeRef ref, size_t depth);
+
+      /*! optimizes the treelet rooted at the specified node */
+      void optimize(AlignedNode* root, size_t depth);
+
+      /*! returns the height of some subtree */
+      static size_t height(NodeRef ref);
+
+    private:
+      BVH* bvh;    //!< BVH to restructure
+    };
+  }
+}
@@ -0,0 +1,170 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh.h"
+#include "bvh_intersector_node.h"
+#include "../common/sah_costs.h"
+
+#include "../geometry/triangle_intersector.h"
+#include "../geometry/trianglev_intersector.h"
+#include "../geometry/quadv_intersector.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    static const size_t CALIBRATION_ITERATIONS  = 64*1024;
+    static const size_t CALIBRATION_REPETITIONS = 8;
+    static const size_t CALIBRATION_SET_SIZE    = 16;
+
+    /*! returns some deterministic pseudo random number in [0,1) */
+    __forceinline float calibrationRandom(unsigned& state)
+    {
+      state = 1664525*state + 1013904223;
+      return float(state >> 8)*(1.0f/16777216.0f);
+    }
+
+    __forceinline Vec3fa calibrationRandomVec3fa(unsigned& state)
+    {
+      const float x = calibrationRandom(state);
+      const float y = calibrationRandom(state);
+      const float z = calibrationRandom(state);
+      return Vec3fa(x,y,z);
+    }
+
+    /*! measures the minimal time of the kernel per iteration in ns */
+    template<typename Kernel>
+    float measureCost(const Kernel& kernel)
+    {
+      double best = inf;
+      for (size_t r=0; r<CALIBRATION_REPETITIONS; r++)
+      {
+        const double t0 = getSeconds();
+        kernel(CALIBRATION_ITERATIONS);
+        const double t1 = getSeconds();
+        best = min(best,t1-t0);
+      }
+      return float(1E9*best/double(CALIBRATION_ITERATIONS));
+    }
+
+    /*! measures the cost to traverse an N-wide node */
+    template<int N>
+    float measureNodeCost()
+    {
+      typedef typename BVHN<N>::AlignedNode AlignedNode;
+      static const int Nx = vextend<N>::size;
+
+      unsigned state = 0;
+      AlignedNode nodes[CALIBRATION_SET_SIZE];
+      TravRay<N,Nx> rays[CALIBRATION_SET_SIZE];
+      for (size_t i=0; i<CALIBRATION_SET_SIZE; i++)
+      {
+        nodes[i].clear();
+        for (size_t j=0; j<N; j++) {
+          const Vec3fa p = calibrationRandomVec3fa(state);
+          nodes[i].set(j,BVHN<N>::emptyNode,BBox3fa(p,p+0.5f*calibrationRandomVec3fa(state)));
+        }
+        rays[i] = TravRay<N,Nx>(Vec3fa(-1.0f),calibrationRandomVec3fa(state)+Vec3fa(0.1f));
+      }
+
+      volatile size_t sink = 0;
+      auto kernel = [&] (size_t n)
+      {
+        size_t hits = 0;
+        vfloat<Nx> dist;
+        for (size_t i=0; i<n; i++) {
+          const AlignedNode* node = &nodes[i % CALIBRATION_SET_SIZE];
+          const TravRay<N,Nx>& ray = rays[(i/CALIBRATION_SET_SIZE) % CALIBRATION_SET_SIZE];
+          hits += intersectNode<N,Nx>(node,ray,vfloat<Nx>(zero),vfloat<Nx>(inf),dist);
+        }
+        sink = hits;
+      };
+      return measureCost(kernel);
+    }
+
+    /*! measures the cost to intersect a leaf block, the rays end
+     *  before they reach the primitives such that all rays miss */
+    template<typename Intersector, typename CreatePrimitive>
+    float measureLeafCost(const CreatePrimitive& createPrimitive)
+    {
+      typedef typename Intersector::Primitive Primitive;
+      typedef typename Intersector::Precalculations Precalculations;
+
+      unsigned state = 1;
+      Primitive prims[CALIBRATION_SET_SIZE];
+      Ray rays[CALIBRATION_SET_SIZE];
+      for (size_t i=0; i<CALIBRATION_SET_SIZE; i++) {
+        prims[i] = createPrimitive(state);
+        rays[i] = Ray(Vec3fa(-1.0f),calibrationRandomVec3fa(state)+Vec3fa(0.1f),0.0f,1E-6f);
+      }
+
+      volatile float sink = 0.0f;
+      auto kernel = [&] (size_t n)
+      {
+        float tfar = 0.0f;
+        for (size_t i=0; i<n; i++) {
+          Ray& ray = rays[(i/CALIBRATION_SET_SIZE) % CALIBRATION_SET_SIZE];
+          Precalculations pre(ray,nullptr);
+          Intersector::intersect(pre,ray,nullptr,prims[i % CALIBRATION_SET_SIZE]);
+          tfar += ray.tfar;
+        }
+        sink = tfar;
+      };
+      return measureCost(kernel);
+    }
+
+    template<int M>
+    __forceinline Vec3vf<M> calibrationRandomVec3vf(unsigned& state)
+    {
+      Vec3vf<M> v;
+      for (size_t i=0; i<M; i++) {
+        const Vec3fa p = calibrationRandomVec3fa(state);
+        v.x[i] = p.x; v.y[i] = p.y; v.z[i] = p.z;
+      }
+      return v;
+    }
+
+    template<typename Triangle, int M>
+    Triangle createTriangle(unsigned& state)
+    {
+      const Vec3vf<M> v0 = calibrationRandomVec3vf<M>(state);
+      const Vec3vf<M> v1 = calibrationRandomVec3vf<M>(state);
+      const Vec3vf<M> v2 = calibrationRandomVec3vf<M>(state);
+      return Triangle(v0,v1,v2,vint<M>(zero),vint<M>(step));
+    }
+
+    Quad4v createQuad4v(unsigned& state)
+    {
+      const Vec3vf4 v0 = calibrationRandomVec3vf<4>(state);
+      const Vec3vf4 v1 = calibrationRandomVec3vf<4>(state);
+      const Vec3vf4 v2 = calibrationRandomVec3vf<4>(state);
+      const Vec3vf4 v3 = calibrationRandomVec3vf<4>(state);
+      return Quad4v(v0,v1,v2,v3,vint4(zero),vint4(step));
+    }
+
+    void calibrateSAHCosts(SAHCosts& costs)
+    {
+      costs.nodeCost[4] = measureNodeCost<4>();
+      costs.leafCost[Triangle4::type.name]  = measureLeafCost<TriangleMIntersector1Moeller<SIMD_MODE(4),true>>(createTriangle<Triangle4,4>);
+      costs.leafCost[Triangle4v::type.name] = measureLeafCost<TriangleMvIntersector1Pluecker<SIMD_MODE(4),true>>(createTriangle<Triangle4v,4>);
+      costs.leafCost[Quad4v::type.name]     = measureLeafCost<QuadMvIntersector1Moeller<4,true>>(createQuad4v);
+#if defined(__AVX__)
+      costs.nodeCost[8] = measureNodeCost<8>();
+      costs.leafCost[Triangle8Type::type.name] = measureLeafCost<TriangleMIntersector1Moeller<SIMD_MODE(8),true>>(createTriangle<Triangle8,8>);
+#endif
+    }
+  }
+}
@@ -87,6 +87,54 @@ namespace embree
   };
 
   fast_allocator_regression_test fast_allocator_regression;
+
+  struct block_pool_regression_test : public RegressionTest
+  {
+    block_pool_regression_test() 
+      : RegressionTest("block_pool_regression_test")
+    {
+      registerRegressionTest(this);
+    }
+
+    bool run ()
+    {
+      bool passed = true;
+      const size_t numBlocks = 16;
+      Ref<BlockPool> pool = new BlockPool(nullptr,2);
+      std::unique_ptr<FastAllocator> alloc = make_unique(new FastAllocator(nullptr,false));
+      alloc->setBlockPool(pool.ptr);
+
+      for (size_t frame=0; frame<4; frame++)
+      {
+        /* each allocation fills an entire block */
+        for (size_t i=0; i<numBlocks; i++) {
+          size_t bytes = 256*1024;
+          char* ptr = (char*) alloc->malloc(bytes,64,false);
+          memset(ptr,int(i),bytes);
+        }
+        alloc->clear();
+        pool->commit();
+
+        /* the blocks of the previous frame have to get recycled */
+        BlockPool::Statistics stat = pool->getStatistics();
+        passed &= stat.numReleased == (frame+1)*numBlocks;
+        passed &= stat.numRecycled == frame*numBlocks;
+        passed &= stat.numRetained == numBlocks;
+      }
+
+      /* the blocks have to get trimmed when they stay unused */
+      pool->commit();
+      pool->commit();
+      BlockPool::Statistics stat = pool->getStatistics();
+      passed &= stat.numTrimmed == numBlocks;
+      passed &= stat.numRetained == 0;
+
+      alloc = nullptr;
+      return passed;
+    }
+  };
+
+  block_pool_regression_test block_pool_regression;
 }
 
 
@@ -20,6 +20,7 @@
 #include "device.h"
 #include "scene.h"
 #include "primref.h"
+#include "block_pool.h"
 
 namespace embree
 {
@@ -219,6 +220,11 @@ namespace embree
       atype = flag ? OS_MALLOC : ALIGNED_MALLOC;
     }
 
+    /*! releases blocks into the pool when cleared and reuses blocks of the pool */
+    void setBlockPool(BlockPool* pool_i) {
+      pool = pool_i;
+    }
+
   private:
 
     /*! returns both fast thread local allocators */
@@ -397,7 +403,7 @@ namespace embree
       slotMask = MAX_THREAD_USED_BLOCK_SLOTS-1; // FIXME: remove
       if (usedBlocks.load() || freeBlocks.load()) { reset(); return; }
       if (bytesReserve == 0) bytesReserve = bytesAllocate;
-      freeBlocks = Block::create(device,bytesAllocate,bytesReserve,nullptr,atype);
+      freeBlocks = Block::create(device,pool.ptr,bytesAllocate,bytesReserve,nullptr,atype);
       estimatedSize = bytesEstimate;
       initGrowSizeAndNumSlots(bytesEstimate,true);
     }
@@ -463,8 +469,8 @@ namespace embree
       bytesUsed.store(0);
       bytesFree.store(0);
       bytesWasted.store(0);
-      if (usedBlocks.load() != nullptr) usedBlocks.load()->clear_list(device); usedBlocks = nullptr;
-      if (freeBlocks.load() != nullptr) freeBlocks.load()->clear_list(device); freeBlocks = nullptr;
+      if (usedBlocks.load() != nullptr) usedBlocks.load()->clear_list(device,pool.ptr); usedBlocks = nullptr;
+      if (freeBlocks.load() != nullptr) freeBlocks.load()->clear_list(device,pool.ptr); freeBlocks = nullptr;
       for (size_t i=0; i<MAX_THREAD_USED_BLOCK_SLOTS; i++) {
         threadUsedBlocks[i] = nullptr;
         threadBlocks[i] = nullptr;
@@ -472,6 +478,37 @@ namespace embree
       primrefarray.clear();
     }
 
+    /*! replaces all blocks by a single block of bytes size, the copy
+     *  function gets passed the start of that block and has to move
+     *  all data over, afterwards the old blocks get freed */
+    template<typename Copy>
+    void compact(size_t bytes, const Copy& copy)
+    {
+      cleanup();
+      bytes = (bytes+maxAlignment-1) & ~(maxAlignment-1);
+      Block* block = Block::create(device,pool.ptr,bytes,bytes,nullptr,atype);
+      size_t blockBytes = bytes;
+      char* ptr = (char*) block->malloc(device,blockBytes,maxAlignment,false);
+      assert(ptr && blockBytes == bytes);
+      copy(ptr);
+
+      Block* oldUsedBlocks = usedBlocks.load();
+      Block* oldFreeBlocks = freeBlocks.load();
+      usedBlocks = block;
+      freeBlocks = nullptr;
+      for (size_t i=0; i<MAX_THREAD_USED_BLOCK_SLOTS; i++) {
+        threadUsedBlocks[i] = nullptr;
+        threadBlocks[i] = nullptr;
+      }
+      if (oldUsedBlocks) oldUsedBlocks->clear_list(device,pool.ptr);
+      if (oldFreeBlocks) oldFreeBlocks->clear_list(device,pool.ptr);
+      primrefarray.clear();
+
+      bytesUsed.store(bytes);
+      bytesFree.store(0);
+      bytesWasted.store(0);
+    }
+
     __forceinline size_t incGrowSizeScale()
     {
       size_t scale = log2_grow_size_scale.fetch_add(1)+1;
@@ -506,7 +543,7 @@ namespace embree
             const size_t alignedBytes = (bytes+(align-1)) & ~(align-1);
             const size_t allocSize = max(min(growSize,maxGrowSize),alignedBytes);
             assert(allocSize >= bytes);
-            threadBlocks[slot] = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,threadBlocks[slot],atype); // FIXME: a large allocation might throw away a block here!
+            threadBlocks[slot] = threadUsedBlocks[slot] = Block::create(device,pool.ptr,allocSize,allocSize,threadBlocks[slot],atype); // FIXME: a large allocation might throw away a block here!
             // FIXME: a direct allocation should allocate inside the block here, and not in the next loop! a different thread could do some allocation and make the large allocation fail.
           }
           continue;
@@ -526,7 +563,7 @@ namespace embree
 	      freeBlocks = nextFreeBlock;
 	    } else {
               const size_t allocSize = min(growSize*incGrowSizeScale(),maxGrowSize);
-	      usedBlocks = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,usedBlocks,atype); // FIXME: a large allocation should get delivered directly, like above!
+	      usedBlocks = threadUsedBlocks[slot] = Block::create(device,pool.ptr,allocSize,allocSize,usedBlocks,atype); // FIXME: a large allocation should get delivered directly, like above!
 	    }
           }
         }
@@ -711,7 +748,7 @@ namespace embree
 
     struct Block
     {
-      static Block* create(MemoryMonitorInterface* device, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype)
+      static Block* create(MemoryMonitorInterface* device, BlockPool* pool, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype)
       {
         /* We avoid using os_malloc for small blocks as this could
          * cause a risk of fragmenting the virtual address space and
@@ -730,6 +767,21 @@ namespace embree
           bytesReserve  = ((bytesReserve +PAGE_SIZE-1) & ~(PAGE_SIZE-1));
         }
 
+        /* reuse some block of the pool, its memory is already accounted for */
+        BlockPool::Item item;
+        if (pool && pool->take(atype == OS_MALLOC ? bytesReserve : bytesAllocate,atype == OS_MALLOC,item))
+        {
+          if (atype == ALIGNED_MALLOC)
+            return new (item.ptr) Block(ALIGNED_MALLOC,item.bytesReserved-sizeof_Header,item.bytesReserved-sizeof_Header,next,maxAlignment);
+
+          const size_t bytesAllocated = max(item.bytesAllocated,bytesAllocate);
+          if (device && bytesAllocated > item.bytesAllocated) {
+            try { device->memoryMonitor(bytesAllocated-item.bytesAllocated,false); }
+            catch (...) { pool->release(item); throw; }
+          }
+          return new (item.ptr) Block(OS_MALLOC,bytesAllocated-sizeof_Header,item.bytesReserved-sizeof_Header,next,0,item.hugePages);
+        }
+
         /* either use alignedMalloc or os_malloc */
         void *ptr = nullptr;
         if (atype == ALIGNED_MALLOC)
@@ -739,7 +791,7 @@ namespace embree
           {
             const size_t alignment = maxAlignment;
             if (device) device->memoryMonitor(bytesAllocate+alignment,false);
-            ptr = alignedMalloc(bytesAllocate,alignment);
+            ptr = device ? device->allocAligned(bytesAllocate,alignment) : alignedMalloc(bytesAllocate,alignment);
 
             /* give hint to transparently convert these pages to 2MB pages */
             const size_t ptr_aligned_begin = ((size_t)ptr) & ~size_t(PAGE_SIZE_2M-1);
@@ -753,14 +805,14 @@ namespace embree
           {
             const size_t alignment = maxAlignment;
             if (device) device->memoryMonitor(bytesAllocate+alignment,false);
-            ptr = alignedMalloc(bytesAllocate,alignment);
+            ptr = device ? device->allocAligned(bytesAllocate,alignment) : alignedMalloc(bytesAllocate,alignment);
             return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment);
           }
         }
         else if (atype == OS_MALLOC)
         {
           if (device) device->memoryMonitor(bytesAllocate,false);
-          bool huge_pages; ptr = os_malloc(bytesReserve,huge_pages);
+          bool huge_pages; ptr = device ? device->allocPages(bytesReserve,huge_pages) : os_malloc(bytesReserve,huge_pages);
           return new (ptr) Block(OS_MALLOC,bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next,0,huge_pages);
         }
         else
@@ -784,29 +836,38 @@ namespace embree
         return head;
       }
 
-      void clear_list(MemoryMonitorInterface* device)
+      void clear_list(MemoryMonitorInterface* device, BlockPool* pool)
       {
         Block* block = this;
         while (block) {
           Block* next = block->next;
-          block->clear_block(device);
+          block->clear_block(device,pool);
           block = next;
         }
       }
 
-      void clear_block (MemoryMonitorInterface* device)
+      void clear_block (MemoryMonitorInterface* device, BlockPool* pool)
       {
         const size_t sizeof_Header = offsetof(Block,data[0]);
         const ssize_t sizeof_Alloced = wasted+sizeof_Header+getBlockAllocatedBytes();
 
+        /* keep the block for later reuse */
+        if (pool && atype != SHARED) {
+          BlockPool::Item item = { this, sizeof_Header+reserveEnd, size_t(sizeof_Alloced), atype == OS_MALLOC, huge_pages };
+          pool->release(item);
+          return;
+        }
+
         if (atype == ALIGNED_MALLOC) {
-          alignedFree(this);
+          if (device) device->freeAligned(this);
+          else        alignedFree(this);
           if (device) device->memoryMonitor(-sizeof_Alloced,true);
         }
 
         else if (atype == OS_MALLOC) {
          size_t sizeof_This = sizeof_Header+reserveEnd;
-         os_free(this,sizeof_This,huge_pages);
+         if (device) device->freePages(this,sizeof_This,huge_pages);
+         else        os_free(this,sizeof_This,huge_pages);
          if (device) device->memoryMonitor(-sizeof_Alloced,true);
         }
 
@@ -955,6 +1016,7 @@ namespace embree
     std::atomic<size_t> bytesUsed;
     std::atomic<size_t> bytesFree;
     std::atomic<size_t> bytesWasted;
+    Ref<BlockPool> pool;                      //!< pool blocks get released to when the allocator gets cleared
     static __thread ThreadLocal2* thread_local_allocator2;
     static SpinLock s_thread_local_allocators_lock;
     static std::vector<std::unique_ptr<ThreadLocal2>> s_thread_local_allocators;
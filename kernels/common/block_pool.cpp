@@ -0,0 +1,139 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "block_pool.h"
+
+namespace embree
+{
+  void BlockPool::Statistics::print() const
+  {
+    std::cout << "  recycled = " << numRecycled << " blocks, " << 1E-6f*bytesRecycled << " MB" << std::endl;
+    std::cout << "  missed   = " << numMissed << " blocks" << std::endl;
+    std::cout << "  released = " << numReleased << " blocks" << std::endl;
+    std::cout << "  trimmed  = " << numTrimmed << " blocks, " << 1E-6f*bytesTrimmed << " MB" << std::endl;
+    std::cout << "  retained = " << numRetained << " blocks, " << 1E-6f*bytesRetained << " MB" << std::endl;
+  }
+
+  BlockPool::BlockPool (MemoryMonitorInterface* device, size_t trimCommits)
+    : device(device), trimCommits(trimCommits), idleCommits(0), idleBytes(inf), minRetainedBytes(0) {}
+
+  BlockPool::~BlockPool () {
+    clear();
+  }
+
+  bool BlockPool::take(size_t bytesReserve, bool osAllocation, Item& item)
+  {
+    Lock<MutexSys> lock(mutex);
+
+    /* we only hand out blocks that waste at most half of their size */
+    std::multimap<size_t,Item>& pool = items[osAllocation];
+    auto i = pool.lower_bound(bytesReserve);
+    if (i == pool.end() || i->first > 2*bytesReserve) {
+      stat.numMissed++;
+      return false;
+    }
+    item = i->second;
+    pool.erase(i);
+
+    stat.numRecycled++;
+    stat.bytesRecycled += item.bytesAllocated;
+    stat.numRetained--;
+    stat.bytesRetained -= item.bytesAllocated;
+    minRetainedBytes = min(minRetainedBytes,stat.bytesRetained);
+    return true;
+  }
+
+  void BlockPool::release(const Item& item)
+  {
+    Lock<MutexSys> lock(mutex);
+    items[item.osAllocation].insert(std::make_pair(item.bytesReserved,item));
+    stat.numReleased++;
+    stat.numRetained++;
+    stat.bytesRetained += item.bytesAllocated;
+  }
+
+  void BlockPool::commit()
+  {
+    Lock<MutexSys> lock(mutex);
+
+    /* count the number of commits some blocks stayed unused */
+    if (minRetainedBytes == 0) {
+      idleCommits = 0;
+      idleBytes = inf;
+    } else {
+      idleCommits++;
+      idleBytes = min(idleBytes,minRetainedBytes);
+    }
+
+    /* trim blocks that were not required during the last trimCommits commits */
+    if (idleCommits >= trimCommits)
+    {
+      size_t bytesTrim = idleBytes;
+      for (auto& pool : items)
+      {
+        for (auto i = pool.rbegin(); i != pool.rend(); )
+        {
+          if (i->second.bytesAllocated > bytesTrim) { ++i; continue; }
+          bytesTrim -= i->second.bytesAllocated;
+          stat.numTrimmed++;
+          stat.bytesTrimmed += i->second.bytesAllocated;
+          stat.numRetained--;
+          stat.bytesRetained -= i->second.bytesAllocated;
+          free(i->second);
+          i = std::multimap<size_t,Item>::reverse_iterator(pool.erase(std::next(i).base()));
+        }
+      }
+      idleCommits = 0;
+      idleBytes = inf;
+    }
+    minRetainedBytes = stat.bytesRetained;
+  }
+
+  void BlockPool::clear()
+  {
+    Lock<MutexSys> lock(mutex);
+    for (auto& pool : items) {
+      for (auto& i : pool) free(i.second);
+      pool.clear();
+    }
+    stat.numRetained = 0;
+    stat.bytesRetained = 0;
+    idleCommits = 0;
+    idleBytes = inf;
+    minRetainedBytes = 0;
+  }
+
+  BlockPool::Statistics BlockPool::getStatistics()
+  {
+    Lock<MutexSys> lock(mutex);
+    return stat;
+  }
+
+  void BlockPool::free(const Item& item)
+  {
+    if (device)
+    {
+      if (item.osAllocation) device->freePages(item.ptr,item.bytesReserved,item.hugePages);
+      else                   device->freeAligned(item.ptr);
+      device->memoryMonitor(-ssize_t(item.bytesAllocated),true);
+    }
+    else
+    {
+      if (item.osAllocation) os_free(item.ptr,item.bytesReserved,item.hugePages);
+      else                   alignedFree(item.ptr);
+    }
+  }
+}
@@ -0,0 +1,99 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "default.h"
+
+namespace embree
+{
+  /*! Pool of memory blocks the FastAllocator of dynamic scenes
+   *  released. Instead of returning a block to the OS when a BVH gets
+   *  cleared, the block stays mapped (and its pages faulted in) and
+   *  gets handed out to the next allocator requesting a block of
+   *  similar size. Blocks that stayed unused for several commits get
+   *  trimmed. */
+  class BlockPool : public RefCount
+  {
+  public:
+
+    /*! memory block stored in the pool */
+    struct Item
+    {
+      void* ptr;              //!< start of the block
+      size_t bytesReserved;   //!< size of the memory region of the block
+      size_t bytesAllocated;  //!< bytes of the block accounted at the memory monitor
+      bool osAllocation;      //!< block got allocated using os_malloc
+      bool hugePages;         //!< block is backed by huge pages
+    };
+
+    /*! recycling statistics */
+    struct Statistics
+    {
+      Statistics ()
+        : numRecycled(0), bytesRecycled(0), numMissed(0), numReleased(0), numTrimmed(0), bytesTrimmed(0), numRetained(0), bytesRetained(0) {}
+
+      void print() const;
+
+    public:
+      size_t numRecycled;     //!< number of blocks handed out again
+      size_t bytesRecycled;   //!< bytes of blocks handed out again
+      size_t numMissed;       //!< number of block requests the pool could not serve
+      size_t numReleased;     //!< number of blocks released into the pool
+      size_t numTrimmed;      //!< number of blocks returned to the OS
+      size_t bytesTrimmed;    //!< bytes of blocks returned to the OS
+      size_t numRetained;     //!< number of blocks currently in the pool
+      size_t bytesRetained;   //!< bytes of blocks currently in the pool
+    };
+
+    /*! Constructor. Blocks that stayed unused for trimCommits commits get trimmed. */
+    BlockPool (MemoryMonitorInterface* device, size_t trimCommits);
+
+    /*! Destruction returns all blocks to the OS. */
+    ~BlockPool ();
+
+    /*! takes a block of at least bytesReserve bytes out of the pool,
+     *  returns false if no suitable block is available */
+    bool take(size_t bytesReserve, bool osAllocation, Item& item);
+
+    /*! releases a block into the pool */
+    void release(const Item& item);
+
+    /*! called after each commit, trims the blocks that stayed unused for the last commits */
+    void commit();
+
+    /*! returns all blocks to the OS */
+    void clear();
+
+    /*! returns recycling statistics */
+    Statistics getStatistics();
+
+  private:
+
+    /*! returns a block to the OS */
+    void free(const Item& item);
+
+  private:
+    MemoryMonitorInterface* device;
+    MutexSys mutex;
+    std::multimap<size_t,Item> items[2];   //!< blocks sorted by size, separately for aligned and os allocations
+    Statistics stat;
+    size_t trimCommits;                    //!< number of commits a block has to stay unused before it gets trimmed
+    size_t idleCommits;                    //!< number of last commits some blocks stayed unused
+    size_t idleBytes;                      //!< bytes that stayed unused during the last idleCommits commits
+    size_t minRetainedBytes;               //!< minimal number of retained bytes during the current commit
+  };
+}
@@ -200,7 +200,7 @@ namespace embree
     /*! allocated buffer */
     void alloc() {
       if (device) device->memoryMonitor(this->bytes(),false);
-      ptr = this->ptr_ofs = (char*) alignedMalloc(this->bytes());
+      ptr = this->ptr_ofs = (char*) (device ? device->allocAligned(this->bytes(),64) : alignedMalloc(this->bytes()));
       allocated = true; // this flag is sticky, such that we do never allocated a buffer again after it was freed
     }
     
@@ -208,7 +208,8 @@ namespace embree
     void free()
     {
       if (shared || !ptr) return;
-      alignedFree(ptr); 
+      if (device) device->freeAligned(ptr);
+      else        alignedFree(ptr); 
       if (device) device->memoryMonitor(-ssize_t(this->bytes()),true);
       ptr = nullptr; this->ptr_ofs = nullptr;
     }
@@ -44,13 +44,15 @@ namespace embree
   ssize_t Device::debug_int3 = 0;
 
   DECLARE_SYMBOL2(RayStreamFilterFuncs,rayStreamFilterFuncs);
+  DECLARE_ISA_FUNCTION(void,calibrateSAHCosts,SAHCosts&);
 
   static MutexSys g_mutex;
   static std::map<Device*,size_t> g_cache_size_map;
   static std::map<Device*,size_t> g_num_threads_map;
+  static Device* g_parallel_for_device = nullptr;
 
   Device::Device (const char* cfg, bool singledevice)
-    : State(singledevice)
+    : State(singledevice), numAllocations(0)
   {
     /* check CPU */
     if (!hasISA(ISA)) 
@@ -114,10 +116,32 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_SSE42_AVX_AVX2_AVX512KNL_AVX512SKX(enabled_cpu_features,rayStreamFilterFuncs);
     rayStreamFilters = rayStreamFilterFuncs();
 #endif
+
+    /* measure SAH costs, or reuse the ones stored for this CPU */
+    if (State::sah_calibration)
+    {
+      const FileName file(State::sah_calibration_file);
+      if (State::sah_calibration_file == "" || !sah_costs.load(file,enabled_cpu_features))
+      {
+        calibrateSAHCostsTy calibrateSAHCosts = nullptr;
+        SELECT_SYMBOL_DEFAULT_SSE42_AVX_AVX2_AVX512KNL_AVX512SKX(enabled_cpu_features,calibrateSAHCosts);
+        calibrateSAHCosts(sah_costs);
+        sah_costs.features = enabled_cpu_features;
+        if (State::sah_calibration_file != "")
+          sah_costs.store(file);
+      }
+      if (State::verbosity(2))
+        sah_costs.print();
+    }
+
+    /* create block pool shared by all scenes */
+    if (State::alloc_pool && State::alloc_pool_shared)
+      block_pool = new BlockPool(this,State::alloc_pool_trim_commits);
   }
 
   Device::~Device ()
   {
+    block_pool = nullptr;
     setCacheSize(0);
     exitTaskingSystem();
   }
@@ -306,6 +330,88 @@ namespace embree
     }
   }
 
+  void* Device::allocAligned(size_t bytes, size_t align)
+  {
+    void* ptr = nullptr;
+    if (State::allocator_functions.alignedMalloc) 
+    {
+      ptr = State::allocator_functions.alignedMalloc(State::allocator_userptr,bytes,align);
+      if (bytes != 0 && ptr == nullptr)
+        throw std::bad_alloc();
+    }
+    else
+      ptr = alignedMalloc(bytes,align);
+
+    if (ptr) numAllocations++;
+    return ptr;
+  }
+
+  void Device::freeAligned(void* ptr)
+  {
+    if (ptr == nullptr) return;
+    numAllocations--;
+    if (State::allocator_functions.alignedFree) 
+      State::allocator_functions.alignedFree(State::allocator_userptr,ptr);
+    else
+      alignedFree(ptr);
+  }
+
+  void* Device::allocPages(size_t bytes, bool& hugepages)
+  {
+    void* ptr = nullptr;
+    if (State::allocator_functions.pageMalloc) 
+    {
+      hugepages = false;
+      ptr = State::allocator_functions.pageMalloc(State::allocator_userptr,bytes,&hugepages);
+      if (bytes != 0 && ptr == nullptr)
+        throw std::bad_alloc();
+    }
+    else
+      ptr = os_malloc(bytes,hugepages);
+
+    if (ptr) numAllocations++;
+    return ptr;
+  }
+
+  void Device::freePages(void* ptr, size_t bytes, bool hugepages)
+  {
+    if (ptr == nullptr) return;
+    numAllocations--;
+    if (State::allocator_functions.pageFree) 
+      State::allocator_functions.pageFree(State::allocator_userptr,ptr,bytes,hugepages);
+    else
+      os_free(ptr,bytes,hugepages);
+  }
+
+  void Device::setAllocatorFunctions(const RTCAllocatorFunctions* functions, void* userPtr)
+  {
+    RTCAllocatorFunctions funcs = { nullptr, nullptr, nullptr, nullptr };
+    if (functions) funcs = *functions;
+
+    if ((funcs.alignedMalloc == nullptr) != (funcs.alignedFree == nullptr) ||
+        (funcs.pageMalloc    == nullptr) != (funcs.pageFree    == nullptr))
+      throw_RTCError(RTC_INVALID_ARGUMENT,"allocation and free function have to get set together");
+
+    /* the functions can only change while the device has no memory
+     * allocated, except for the tessellation cache which gets
+     * allocated again */
+    size_t cacheSize = 0;
+    {
+      Lock<MutexSys> lock(g_mutex);
+      auto i = g_cache_size_map.find(this);
+      if (i != g_cache_size_map.end()) cacheSize = i->second;
+    }
+    setCacheSize(0);
+    if (numAllocations != 0) {
+      setCacheSize(cacheSize);
+      throw_RTCError(RTC_INVALID_OPERATION,"allocation functions cannot change while the device has memory allocated");
+    }
+
+    State::allocator_functions = funcs;
+    State::allocator_userptr = userPtr;
+    setCacheSize(cacheSize);
+  }
+
   size_t getMaxNumThreads()
   {
     size_t maxNumThreads = 0;
@@ -316,12 +422,17 @@ namespace embree
     return maxNumThreads;
   }
 
-  size_t getMaxCacheSize()
+  Device* getMaxCacheSizeDevice()
   {
+    Device* maxCacheDevice = nullptr;
     size_t maxCacheSize = 0;
-    for (std::map<Device*,size_t>::iterator i=g_cache_size_map.begin(); i!= g_cache_size_map.end(); i++)
-      maxCacheSize = max(maxCacheSize, (*i).second);
-    return maxCacheSize;
+    for (std::map<Device*,size_t>::iterator i=g_cache_size_map.begin(); i!= g_cache_size_map.end(); i++) {
+      if ((*i).second > maxCacheSize) {
+        maxCacheDevice = (*i).first;
+        maxCacheSize = (*i).second;
+      }
+    }
+    return maxCacheDevice;
   }
  
   void Device::setCacheSize(size_t bytes) 
@@ -331,8 +442,10 @@ namespace embree
     if (bytes == 0) g_cache_size_map.erase(this);
     else            g_cache_size_map[this] = bytes;
     
-    size_t maxCacheSize = getMaxCacheSize();
-    resizeTessellationCache(maxCacheSize);
+    /* the cache gets allocated through the device requesting the largest cache */
+    Device* maxCacheDevice = getMaxCacheSizeDevice();
+    if (maxCacheDevice) resizeTessellationCache(g_cache_size_map[maxCacheDevice],maxCacheDevice);
+    else                resizeTessellationCache(0,nullptr);
 #endif
   }
 
@@ -346,7 +459,7 @@ namespace embree
 
     /* create task scheduler */
     size_t maxNumThreads = getMaxNumThreads();
-    TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads);
+    TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads,State::idle_park ? ssize_t(State::idle_spin_time) : -1);
 #if USE_TASK_ARENA
     arena = make_unique(new tbb::task_arena((int)min(maxNumThreads,TaskScheduler::threadCount())));
 #endif
@@ -357,6 +470,14 @@ namespace embree
     Lock<MutexSys> lock(g_mutex);
     g_num_threads_map.erase(this);
 
+    /* switch back to internal tasking system */
+#if defined(TASKING_INTERNAL)
+    if (g_parallel_for_device == this) {
+      TaskScheduler::setExternal(nullptr,nullptr,0);
+      g_parallel_for_device = nullptr;
+    }
+#endif
+
     /* terminate tasking system */
     if (g_num_threads_map.size() == 0) {
       TaskScheduler::destroy();
@@ -364,13 +485,27 @@ namespace embree
     /* or configure new number of threads */
     else {
       size_t maxNumThreads = getMaxNumThreads();
-      TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads);
+      TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads,State::idle_park ? ssize_t(State::idle_spin_time) : -1);
     }
 #if USE_TASK_ARENA
     arena.reset();
 #endif
   }
 
+  void Device::setParallelForFunction(RTCParallelForFunc func, void* userPtr, size_t numThreads)
+  {
+#if defined(TASKING_INTERNAL)
+    if (func && numThreads == 0)
+      throw_RTCError(RTC_INVALID_ARGUMENT,"number of threads of tasking system has to be specified");
+
+    Lock<MutexSys> lock(g_mutex);
+    TaskScheduler::setExternal(func,userPtr,numThreads);
+    g_parallel_for_device = func ? this : nullptr;
+#else
+    throw_RTCError(RTC_INVALID_OPERATION,"external tasking system only supported with internal tasking system");
+#endif
+  }
+
   void Device::setParameter1i(const RTCParameter parm, ssize_t val)
   {
     /* hidden internal parameters */
@@ -19,6 +19,8 @@
 #include "default.h"
 #include "state.h"
 #include "accel.h"
+#include "sah_costs.h"
+#include "block_pool.h"
 
 namespace embree
 {
@@ -59,9 +61,21 @@ namespace embree
     /*! invokes the memory monitor callback */
     void memoryMonitor(ssize_t bytes, bool post);
 
+    /*! allocates memory through the allocation functions of the application */
+    void* allocAligned(size_t bytes, size_t align);
+    void freeAligned(void* ptr);
+    void* allocPages(size_t bytes, bool& hugepages);
+    void freePages(void* ptr, size_t bytes, bool hugepages);
+
+    /*! sets the allocation functions of the application */
+    void setAllocatorFunctions(const RTCAllocatorFunctions* functions, void* userPtr);
+
     /*! sets the size of the software cache. */
     void setCacheSize(size_t bytes);
 
+    /*! lets all parallel work run on the tasking system of the application */
+    void setParallelForFunction(RTCParallelForFunc func, void* userPtr, size_t numThreads);
+
     /*! configures some parameter */
     void setParameter1i(const RTCParameter parm, ssize_t val);
 
@@ -98,5 +112,14 @@ namespace embree
     
     /* ray streams filter */
     RayStreamFilterFuncs rayStreamFilters;
+
+    /* SAH costs measured for this CPU */
+    SAHCosts sah_costs;
+
+    /* allocator blocks shared by all dynamic scenes of the device */
+    Ref<BlockPool> block_pool;
+
+  private:
+    std::atomic<size_t> numAllocations;    //!< number of outstanding allocations of the device
   };
 }
@@ -23,12 +23,13 @@ namespace embree
     : scene(scene), geomID(0), type(type), 
       numPrimitives(numPrimitives), numPrimitivesChanged(false),
       numTimeSteps(unsigned(numTimeSteps)), fnumTimeSegments(float(numTimeSteps-1)), flags(flags),
-      enabled(true), modified(true), userPtr(nullptr), mask(-1), used(1),
+      enabled(true), modified(true), userPtr(nullptr), mask(-1), backfaceCulling(false), used(1),
       intersectionFilter1(nullptr), occlusionFilter1(nullptr),
       intersectionFilter4(nullptr), occlusionFilter4(nullptr),
       intersectionFilter8(nullptr), occlusionFilter8(nullptr),
       intersectionFilter16(nullptr), occlusionFilter16(nullptr),
       intersectionFilterN(nullptr), occlusionFilterN(nullptr),
+      intersectionFilterBatch(nullptr), occlusionFilterBatch(nullptr),
       hasIntersectionFilterMask(0), hasOcclusionFilterMask(0), ispcIntersectionFilterMask(0), ispcOcclusionFilterMask(0)
   {
     scene->setModified();
@@ -53,7 +54,7 @@ namespace embree
 
   void Geometry::updateIntersectionFilters(bool enable)
   {
-    const size_t num1  = (intersectionFilter1  != nullptr) + (occlusionFilter1  != nullptr);
+    const size_t num1  = (intersectionFilter1  != nullptr) + (occlusionFilter1  != nullptr) + (intersectionFilterBatch != nullptr) + (occlusionFilterBatch != nullptr);
     const size_t num4  = (intersectionFilter4  != nullptr) + (occlusionFilter4  != nullptr);
     const size_t num8  = (intersectionFilter8  != nullptr) + (occlusionFilter8  != nullptr);
     const size_t num16 = (intersectionFilter16 != nullptr) + (occlusionFilter16 != nullptr);
@@ -209,6 +210,23 @@ namespace embree
     if (filter) hasIntersectionFilterMask  |= HAS_FILTERN; else hasIntersectionFilterMask  &= ~HAS_FILTERN;
   }
 
+  void Geometry::setIntersectionFilterFunctionBatch (RTCFilterFuncBatch filter) 
+  { 
+    if (scene->isStreamMode())
+      throw_RTCError(RTC_INVALID_OPERATION,"you have to use rtcSetIntersectionFilterFunctionN in stream mode");
+
+    if (scene->isStatic() && scene->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != LINE_SEGMENTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
+      throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
+
+    scene->numIntersectionFilters1 -= intersectionFilterBatch != nullptr;
+    scene->numIntersectionFilters1 += filter != nullptr;
+    intersectionFilterBatch = filter;
+    if (filter) hasIntersectionFilterMask  |= HAS_FILTER_BATCH; else hasIntersectionFilterMask  &= ~HAS_FILTER_BATCH;
+  }
+
   void Geometry::setOcclusionFilterFunction (RTCFilterFunc filter, bool ispc) 
   {
     if (scene->isStreamMode())
@@ -297,6 +315,23 @@ namespace embree
     if (filter) hasOcclusionFilterMask  |= HAS_FILTERN; else hasOcclusionFilterMask  &= ~HAS_FILTERN;
   }
 
+  void Geometry::setOcclusionFilterFunctionBatch (RTCFilterFuncBatch filter) 
+  { 
+    if (scene->isStreamMode())
+      throw_RTCError(RTC_INVALID_OPERATION,"you have to use rtcSetOcclusionFilterFunctionN in stream mode");
+
+    if (scene->isStatic() && scene->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != LINE_SEGMENTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
+      throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
+
+    scene->numIntersectionFilters1 -= occlusionFilterBatch != nullptr;
+    scene->numIntersectionFilters1 += filter != nullptr;
+    occlusionFilterBatch = filter;
+    if (filter) hasOcclusionFilterMask  |= HAS_FILTER_BATCH; else hasOcclusionFilterMask  &= ~HAS_FILTER_BATCH;
+  }
+
   void Geometry::interpolateN(const void* valid_i, const unsigned* primIDs, const float* u, const float* v, size_t numUVs, 
                               RTCBufferType buffer, float* P, float* dPdu, float* dPdv, float* ddPdudu, float* ddPdvdv, float* ddPdudv, size_t numFloats)
   {
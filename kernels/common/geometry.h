@@ -187,6 +187,11 @@ namespace embree
       throw_RTCError(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Enables or disables culling of back facing hits. */
+    virtual void setBackfaceCulling (bool enable) { 
+      throw_RTCError(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! Maps specified buffer. */
     virtual void* map(RTCBufferType type) { 
       throw_RTCError(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
@@ -228,6 +233,9 @@ namespace embree
     /*! Set intersection filter function for ray packets of size N. */
     virtual void setIntersectionFilterFunctionN (RTCFilterFuncN filterN);
 
+    /*! Set batched intersection filter function for single rays. */
+    virtual void setIntersectionFilterFunctionBatch (RTCFilterFuncBatch filterBatch);
+
     /*! Set occlusion filter function for single rays. */
     virtual void setOcclusionFilterFunction (RTCFilterFunc filter, bool ispc = false);
     
@@ -243,6 +251,9 @@ namespace embree
     /*! Set occlusion filter function for ray packets of size N. */
     virtual void setOcclusionFilterFunctionN (RTCFilterFuncN filterN);
 
+    /*! Set batched occlusion filter function for single rays. */
+    virtual void setOcclusionFilterFunctionBatch (RTCFilterFuncBatch filterBatch);
+
     /*! for instances only */
   public:
     
@@ -335,8 +346,10 @@ namespace embree
     }
 
   public:
-    __forceinline bool hasIntersectionFilter1() const { return (hasIntersectionFilterMask & (HAS_FILTER1 | HAS_FILTERN)) != 0;  }
-    __forceinline bool hasOcclusionFilter1   () const { return (hasOcclusionFilterMask    & (HAS_FILTER1 | HAS_FILTERN)) != 0; }
+    __forceinline bool hasIntersectionFilter1() const { return (hasIntersectionFilterMask & (HAS_FILTER1 | HAS_FILTERN | HAS_FILTER_BATCH)) != 0;  }
+    __forceinline bool hasOcclusionFilter1   () const { return (hasOcclusionFilterMask    & (HAS_FILTER1 | HAS_FILTERN | HAS_FILTER_BATCH)) != 0; }
+    __forceinline bool hasIntersectionFilterBatch() const { return (hasIntersectionFilterMask & HAS_FILTER_BATCH) != 0;  }
+    __forceinline bool hasOcclusionFilterBatch   () const { return (hasOcclusionFilterMask    & HAS_FILTER_BATCH) != 0; }
     template<typename simd> __forceinline bool hasIntersectionFilter() const;
     template<typename simd> __forceinline bool hasOcclusionFilter() const;
 
@@ -356,6 +369,7 @@ namespace embree
     bool modified;             //!< true if geometry is modified
     void* userPtr;             //!< user pointer
     unsigned mask;             //!< for masking out geometry
+    bool backfaceCulling;      //!< true if hits on back faces get rejected
     std::atomic<size_t> used;  //!< counts by how many enabled instances this geometry is used
     
   public:
@@ -374,8 +388,11 @@ namespace embree
     RTCFilterFuncN intersectionFilterN;
     RTCFilterFuncN occlusionFilterN;
 
+    RTCFilterFuncBatch intersectionFilterBatch;
+    RTCFilterFuncBatch occlusionFilterBatch;
+
   public: 
-    enum { HAS_FILTER1 = 1, HAS_FILTER4 = 2, HAS_FILTER8 = 4, HAS_FILTER16 = 8, HAS_FILTERN = 16 };  
+    enum { HAS_FILTER1 = 1, HAS_FILTER4 = 2, HAS_FILTER8 = 4, HAS_FILTER16 = 8, HAS_FILTERN = 16, HAS_FILTER_BATCH = 32 };  
     int hasIntersectionFilterMask;
     int hasOcclusionFilterMask;
     int ispcIntersectionFilterMask;
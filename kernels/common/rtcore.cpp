@@ -195,6 +195,26 @@ namespace embree
     RTCORE_CATCH_END(device);
   }
 
+  RTCORE_API void rtcDeviceSetAllocatorFunctions(RTCDevice hdevice, const RTCAllocatorFunctions* functions, void* userPtr) 
+  {
+    Device* device = (Device*) hdevice;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcDeviceSetAllocatorFunctions);
+    RTCORE_VERIFY_HANDLE(hdevice);
+    device->setAllocatorFunctions(functions,userPtr);
+    RTCORE_CATCH_END(device);
+  }
+
+  RTCORE_API void rtcDeviceSetParallelForFunction(RTCDevice hdevice, RTCParallelForFunc func, void* userPtr, size_t numThreads) 
+  {
+    Device* device = (Device*) hdevice;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcDeviceSetParallelForFunction);
+    RTCORE_VERIFY_HANDLE(hdevice);
+    device->setParallelForFunction(func,userPtr,numThreads);
+    RTCORE_CATCH_END(device);
+  }
+
   RTCORE_API void rtcDebug() 
   {
     RTCORE_CATCH_BEGIN;
@@ -239,6 +259,16 @@ namespace embree
     scene->setProgressMonitorFunction(func,ptr);
     RTCORE_CATCH_END(scene->device);
   }
+
+  RTCORE_API void rtcSetBuildThreads(RTCScene hscene, size_t numThreads, RTCBuildPriority priority) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSetBuildThreads);
+    RTCORE_VERIFY_HANDLE(hscene);
+    scene->setBuildThreads(numThreads,priority);
+    RTCORE_CATCH_END(scene->device);
+  }
   
   RTCORE_API void rtcCommit (RTCScene hscene) 
   {
@@ -1284,6 +1314,17 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API void rtcSetBackfaceCulling (RTCScene hscene, unsigned geomID, bool enable) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSetBackfaceCulling);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_GEOMID(geomID);
+    scene->get_locked(geomID)->setBackfaceCulling(enable);
+    RTCORE_CATCH_END(scene->device);
+  }
+
   RTCORE_API void rtcSetBoundaryMode (RTCScene hscene, unsigned geomID, RTCBoundaryMode mode) 
   {
     Scene* scene = (Scene*) hscene;
@@ -1364,6 +1405,18 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API unsigned rtcNewGeometries(RTCScene hscene, RTCGeometryType type, const RTCGeometryDescriptor* geometries, size_t numGeometries)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcNewGeometries);
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (numGeometries) RTCORE_VERIFY_HANDLE(geometries);
+    return scene->newGeometries(type,geometries,numGeometries);
+    RTCORE_CATCH_END(scene->device);
+    return -1;
+  }
+
   RTCORE_API void rtcEnable (RTCScene hscene, unsigned geomID) 
   {
     Scene* scene = (Scene*) hscene;
@@ -1695,6 +1748,17 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API void rtcSetIntersectionFilterFunctionBatch (RTCScene hscene, unsigned geomID, RTCFilterFuncBatch filterBatch) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSetIntersectionFilterFunctionBatch);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_GEOMID(geomID);
+    scene->get_locked(geomID)->setIntersectionFilterFunctionBatch(filterBatch);
+    RTCORE_CATCH_END(scene->device);
+  }
+
   RTCORE_API void rtcSetOcclusionFilterFunction (RTCScene hscene, unsigned geomID, RTCFilterFunc intersect) 
   {
     Scene* scene = (Scene*) hscene;
@@ -1750,6 +1814,17 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API void rtcSetOcclusionFilterFunctionBatch (RTCScene hscene, unsigned geomID, RTCFilterFuncBatch filterBatch) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSetOcclusionFilterFunctionBatch);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_GEOMID(geomID);
+    scene->get_locked(geomID)->setOcclusionFilterFunctionBatch(filterBatch);
+    RTCORE_CATCH_END(scene->device);
+  }
+
   RTCORE_API void rtcInterpolate(RTCScene hscene, unsigned geomID, unsigned primID, float u, float v, 
                                  RTCBufferType buffer,
                                  float* P, float* dPdu, float* dPdv, size_t numFloats)
@@ -109,6 +109,10 @@ namespace embree
     return rtcSetProgressMonitorFunction(scene,(RTCProgressMonitorFunc)func,ptr);
   }
 
+  extern "C" void ispcSetBuildThreads(RTCScene scene, size_t numThreads, RTCBuildPriority priority) {
+    return rtcSetBuildThreads(scene,numThreads,priority);
+  }
+
   extern "C" void ispcCommit (RTCScene scene) {
     return rtcCommit(scene);
   }
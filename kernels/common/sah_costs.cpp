@@ -0,0 +1,89 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "sah_costs.h"
+#include <fstream>
+
+namespace embree
+{
+  float SAHCosts::intCost(size_t N, const std::string& primType, float defaultCost) const
+  {
+    auto node = nodeCost.find(N);
+    auto leaf = leafCost.find(primType);
+    if (node == nodeCost.end() || leaf == leafCost.end() || node->second <= 0.0f)
+      return defaultCost;
+
+    return leaf->second/node->second;
+  }
+
+  bool SAHCosts::load(const FileName& fileName, int features)
+  {
+    std::ifstream file(fileName.c_str());
+    if (!file.is_open()) return false;
+
+    int fileFeatures = 0;
+    std::map<size_t,float> fileNodeCost;
+    std::map<std::string,float> fileLeafCost;
+
+    std::string name;
+    while (file >> name)
+    {
+      if (name == "features") {
+        file >> fileFeatures;
+      } else if (name == "node") {
+        size_t N = 0; float cost = 0.0f;
+        file >> N >> cost;
+        fileNodeCost[N] = cost;
+      } else if (name == "leaf") {
+        std::string primType; float cost = 0.0f;
+        file >> primType >> cost;
+        fileLeafCost[primType] = cost;
+      } else {
+        return false;
+      }
+      if (file.fail()) return false;
+    }
+
+    /* the costs of a different CPU cannot get reused */
+    if (fileFeatures != features || fileNodeCost.empty())
+      return false;
+
+    this->features = fileFeatures;
+    nodeCost = fileNodeCost;
+    leafCost = fileLeafCost;
+    return true;
+  }
+
+  void SAHCosts::store(const FileName& fileName) const
+  {
+    std::ofstream file(fileName.c_str());
+    if (!file.is_open())
+      throw_RTCError(RTC_INVALID_OPERATION,"cannot write SAH calibration file " + fileName.str());
+
+    file << "features " << features << std::endl;
+    for (auto& node : nodeCost) file << "node " << node.first << " " << node.second << std::endl;
+    for (auto& leaf : leafCost) file << "leaf " << leaf.first << " " << leaf.second << std::endl;
+  }
+
+  void SAHCosts::print() const
+  {
+    std::cout << "SAH costs:" << std::endl;
+    for (auto& node : nodeCost)
+      std::cout << "  node" << node.first << " = " << node.second << " ns" << std::endl;
+    for (auto& leaf : leafCost)
+      std::cout << "  " << leaf.first << " = " << leaf.second << " ns" << std::endl;
+  }
+}
@@ -0,0 +1,57 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "default.h"
+
+namespace embree
+{
+  /*! SAH cost model calibrated for the current CPU. Stores the
+   *  measured time to traverse a BVH node of some width and to
+   *  intersect a leaf block of some primitive type with a single
+   *  ray. */
+  struct SAHCosts
+  {
+    SAHCosts ()
+      : features(0) {}
+
+    /*! checks if the cost model got calibrated */
+    bool calibrated() const {
+      return !nodeCost.empty();
+    }
+
+    /*! returns the cost to intersect a leaf block of the specified
+     *  primitive type relative to the cost of traversing an N-wide
+     *  node, or the default cost if this was not calibrated */
+    float intCost(size_t N, const std::string& primType, float defaultCost) const;
+
+    /*! loads the cost model from a file, fails if the file is missing
+     *  or was calibrated for different CPU features */
+    bool load(const FileName& fileName, int features);
+
+    /*! stores the cost model in a file */
+    void store(const FileName& fileName) const;
+
+    /*! prints the cost model */
+    void print() const;
+
+  public:
+    int features;                          //!< CPU features the costs got measured with
+    std::map<size_t,float> nodeCost;       //!< time in ns to traverse an N-wide node
+    std::map<std::string,float> leafCost;  //!< time in ns to intersect a leaf block of some primitive type
+  };
+}
@@ -41,6 +41,7 @@ namespace embree
       needLineIndices(false), needLineVertices(false),
       needSubdivIndices(false), needSubdivVertices(false),
       is_build(false), modified(true),
+      build_threads(0), build_priority(RTC_BUILD_PRIORITY_NORMAL),
       progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0), 
       numIntersectionFilters1(0), numIntersectionFilters4(0), numIntersectionFilters8(0), numIntersectionFilters16(0), numIntersectionFiltersN(0)
   {
@@ -70,6 +71,10 @@ namespace embree
       needSubdivVertices = true;
     }
 
+    /* dynamic scenes keep the blocks of their allocators across commits */
+    if (!isStatic() && device->alloc_pool)
+      block_pool = device->alloc_pool_shared ? device->block_pool : Ref<BlockPool>(new BlockPool(device,device->alloc_pool_trim_commits));
+
     createTriangleAccel();
     createTriangleMBAccel();
     createQuadAccel();
@@ -165,6 +170,7 @@ namespace embree
     else if (device->tri_accel == "bvh8.triangle4")       accels.add(device->bvh8_factory->BVH8Triangle4 (this));
     else if (device->tri_accel == "bvh8.triangle4v")      accels.add(device->bvh8_factory->BVH8Triangle4v(this));
     else if (device->tri_accel == "bvh8.triangle4i")      accels.add(device->bvh8_factory->BVH8Triangle4i(this));
+    else if (device->tri_accel == "bvh8.triangle8")       accels.add(device->bvh8_factory->BVH8Triangle8 (this));
     else if (device->tri_accel == "qbvh8.triangle4i")     accels.add(device->bvh8_factory->BVH8QuantizedTriangle4i(this));
     else if (device->tri_accel == "qbvh8.triangle4")      accels.add(device->bvh8_factory->BVH8QuantizedTriangle4(this));
 #endif
@@ -178,25 +184,26 @@ namespace embree
     if (device->tri_accel_mb == "default")
     {
       int mode =  2*(int)isCompact() + 1*(int)isRobust(); 
+      const BVHFactory::BuildVariant bvariant = isHighQuality() ? BVHFactory::BuildVariant::HIGH_QUALITY : BVHFactory::BuildVariant::STATIC;
       
 #if defined (EMBREE_TARGET_AVX)
       if (device->hasISA(AVX2)) // BVH8 reduces performance on AVX only-machines
       {
         switch (mode) {
-        case /*0b00*/ 0: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b01*/ 1: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
-        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b00*/ 0: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b01*/ 1: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
         }
       }
       else
 #endif
       {
         switch (mode) {
-        case /*0b00*/ 0: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b01*/ 1: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
-        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b00*/ 0: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b01*/ 1: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
         }
       }
     }
@@ -297,27 +304,28 @@ namespace embree
     if (device->quad_accel_mb == "default") 
     {
       int mode =  2*(int)isCompact() + 1*(int)isRobust(); 
+      const BVHFactory::BuildVariant bvariant = isHighQuality() ? BVHFactory::BuildVariant::HIGH_QUALITY : BVHFactory::BuildVariant::STATIC;
       switch (mode) {
       case /*0b00*/ 0:
 #if defined (EMBREE_TARGET_AVX)
         if (device->hasISA(AVX))
-          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
+          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST));
         else
 #endif
-          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
+          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST));
         break;
 
       case /*0b01*/ 1:
 #if defined (EMBREE_TARGET_AVX)
         if (device->hasISA(AVX))
-          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
+          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST));
         else
 #endif
-          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
+          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST));
         break;
 
-      case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-      case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+      case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+      case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
       }
     }
     else if (device->quad_accel_mb == "bvh4.quad4imb") accels.add(device->bvh4_factory->BVH4Quad4iMB(this));
@@ -687,6 +695,97 @@ namespace embree
   }
 #endif
 
+  unsigned Scene::newGeometries (RTCGeometryType type, const RTCGeometryDescriptor* descs, size_t numGeometries)
+  {
+    if (numGeometries == 0)
+      return RTC_INVALID_GEOMETRY_ID;
+
+    for (size_t i=0; i<numGeometries; i++)
+    {
+      if (isStatic() && (descs[i].flags != RTC_GEOMETRY_STATIC))
+        throw_RTCError(RTC_INVALID_OPERATION,"static scenes can only contain static geometries");
+      
+      if (descs[i].numTimeSteps == 0 || descs[i].numTimeSteps > RTC_MAX_TIME_STEPS)
+        throw_RTCError(RTC_INVALID_OPERATION,"maximal number of timesteps exceeded");
+
+      if (descs[i].numBuffers && descs[i].buffers == nullptr)
+        throw_RTCError(RTC_INVALID_ARGUMENT,"invalid argument");
+
+      for (size_t j=0; j<descs[i].numBuffers; j++)
+        if (descs[i].buffers[j].byteStride > unsigned(inf))
+          throw_RTCError(RTC_INVALID_ARGUMENT,"invalid argument");
+    }
+
+    createTriangleMeshTy createTriangleMesh = nullptr;
+    createQuadMeshTy createQuadMesh = nullptr;
+    createLineSegmentsTy createLineSegments = nullptr;
+    switch (type) {
+#if defined(EMBREE_GEOMETRY_TRIANGLES)
+    case RTC_GEOMETRY_TYPE_TRIANGLE_MESH: SELECT_SYMBOL_DEFAULT_AVX(device->enabled_cpu_features,createTriangleMesh); break;
+#endif
+#if defined(EMBREE_GEOMETRY_QUADS)
+    case RTC_GEOMETRY_TYPE_QUAD_MESH    : SELECT_SYMBOL_DEFAULT_AVX(device->enabled_cpu_features,createQuadMesh); break;
+#endif
+#if defined(EMBREE_GEOMETRY_LINES)
+    case RTC_GEOMETRY_TYPE_LINE_SEGMENTS: SELECT_SYMBOL_DEFAULT_AVX(device->enabled_cpu_features,createLineSegments); break;
+#endif
+    default: throw_RTCError(RTC_INVALID_ARGUMENT,"unsupported geometry type");
+    }
+
+    /* create geometries and share their buffers in parallel, errors
+     * are not propagated through the tasking system as this would
+     * cancel the tasks of the application when called from a task */
+    std::vector<Geometry*> geoms(numGeometries,nullptr);
+    std::exception_ptr error = nullptr;
+    SpinLock errorMutex;
+    parallel_for(size_t(0), numGeometries, size_t(64), [&] ( const range<size_t>& r ) 
+    {
+      try {
+        for (size_t i=r.begin(); i<r.end(); i++)
+        {
+          const RTCGeometryDescriptor& desc = descs[i];
+          Geometry* geom = nullptr;
+          if      (createTriangleMesh) geom = createTriangleMesh(this,desc.flags,desc.numPrimitives,desc.numVertices,desc.numTimeSteps);
+          else if (createQuadMesh    ) geom = createQuadMesh    (this,desc.flags,desc.numPrimitives,desc.numVertices,desc.numTimeSteps);
+          else                         geom = createLineSegments(this,desc.flags,desc.numPrimitives,desc.numVertices,desc.numTimeSteps);
+          geoms[i] = geom;
+
+          for (size_t j=0; j<desc.numBuffers; j++) {
+            const RTCBufferDescriptor& buffer = desc.buffers[j];
+            geom->setBuffer(buffer.type,(void*)buffer.ptr,buffer.byteOffset,buffer.byteStride,buffer.size);
+          }
+        }
+      } 
+      catch (...) {
+        Lock<SpinLock> lock(errorMutex);
+        if (error == nullptr) error = std::current_exception();
+      }
+    });
+
+    if (error != nullptr) 
+    {
+      for (size_t i=0; i<numGeometries; i++) {
+        if (geoms[i] == nullptr) continue;
+        geoms[i]->disabling();
+        delete geoms[i];
+      }
+      std::rethrow_exception(error);
+    }
+
+    /* assign consecutive IDs to all geometries at once */
+    Lock<SpinLock> lock(geometriesMutex);
+    const unsigned geomID = id_pool.allocateRange(unsigned(numGeometries));
+    if (geomID+numGeometries > geometries.size()) {
+      geometries.resize(geomID+numGeometries);
+      vertices.resize(geomID+numGeometries);
+    }
+    for (size_t i=0; i<numGeometries; i++) {
+      geometries[geomID+i] = geoms[i];
+      geoms[i]->geomID = unsigned(geomID+i);
+    }
+    return geomID;
+  }
+
   unsigned Scene::bind(unsigned geomID, Geometry* geometry) 
   {
     Lock<SpinLock> lock(geometriesMutex);
@@ -762,6 +861,9 @@ namespace embree
     /* build all hierarchies of this scene */
     accels.build();
 
+    /* trim the blocks the builds did not require for some commits */
+    if (block_pool) block_pool->commit();
+
     /* make static geometry immutable */
     if (isStatic()) accels.immutable();
 
@@ -777,6 +879,10 @@ namespace embree
       accels.print(2);
       std::cout << "selected scene intersector" << std::endl;
       intersectors.print(2);
+      if (block_pool) {
+        std::cout << "block pool" << std::endl;
+        block_pool->getStatistics().print();
+      }
     }
     
     setModified(false);
@@ -795,7 +901,7 @@ namespace embree
       scheduler = this->scheduler;
       if (scheduler == null) {
         buildLock.lock();
-        this->scheduler = scheduler = new TaskScheduler;
+        this->scheduler = scheduler = new TaskScheduler(build_threads,int(build_priority));
       }
     }
 
@@ -838,6 +944,11 @@ namespace embree
 
   void Scene::commit (size_t threadIndex, size_t threadCount, bool useThreadPool) 
   {
+#if USE_TASK_ARENA
+    /* builds with limited number of threads run in their own arena */
+    tbb::task_arena* arena = build_arena ? build_arena.get() : device->arena.get();
+#endif
+
     /* let threads wait for build to finish in rtcCommitThread mode */
     if (threadCount != 0) {
 #if defined(TASKING_TBB) && (TBB_INTERFACE_VERSION_MAJOR < 8)
@@ -859,7 +970,7 @@ namespace embree
       throw_RTCError(RTC_INVALID_OPERATION,"join not supported");
 #endif
 #if USE_TASK_ARENA
-      device->arena->execute([&]{ group->wait(); });
+      arena->execute([&]{ group->wait(); });
 #else
       group->wait();
 #endif
@@ -867,7 +978,7 @@ namespace embree
         __pause_cpu();
         yield();
 #if USE_TASK_ARENA
-        device->arena->execute([&]{ group->wait(); });
+        arena->execute([&]{ group->wait(); });
 #else
         group->wait();
 #endif
@@ -898,10 +1009,16 @@ namespace embree
 #else
       tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits | tbb::task_group_context::fp_settings );
 #endif
-      //ctx.set_priority(tbb::priority_high);
+#if __TBB_TASK_PRIORITY
+      switch (build_priority) {
+      case RTC_BUILD_PRIORITY_LOW : ctx.set_priority(tbb::priority_low ); break;
+      case RTC_BUILD_PRIORITY_HIGH: ctx.set_priority(tbb::priority_high); break;
+      default                     : break;
+      }
+#endif
 
 #if USE_TASK_ARENA
-      device->arena->execute([&]{
+      arena->execute([&]{
 #endif
           group->run([&]{
               tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { commit_task(); }, ctx);
@@ -944,6 +1061,26 @@ namespace embree
     mutex.unlock();
   }
 
+  void Scene::setBuildThreads(size_t numThreads, RTCBuildPriority priority)
+  {
+    if (priority < RTC_BUILD_PRIORITY_LOW || priority > RTC_BUILD_PRIORITY_HIGH)
+      throw_RTCError(RTC_INVALID_ARGUMENT,"invalid build priority");
+
+    /* cannot change the settings of a running build */
+    Lock<MutexSys> lock(buildMutex);
+    build_threads = numThreads;
+    build_priority = priority;
+#if USE_TASK_ARENA
+    if (numThreads) {
+      size_t maxThreads = TaskScheduler::threadCount();
+      if (device->numThreads) maxThreads = min(maxThreads,device->numThreads);
+      build_arena = make_unique(new tbb::task_arena((int)min(numThreads,maxThreads)));
+    }
+    else
+      build_arena.reset();
+#endif
+  }
+
   void Scene::progressMonitor(double dn)
   {
     if (progress_monitor_function) {
@@ -155,6 +155,9 @@ namespace embree
     /*! Creates a new subdivision mesh. */
     unsigned int newSubdivisionMesh (unsigned int geomID, RTCGeometryFlags flags, size_t numFaces, size_t numEdges, size_t numVertices, size_t numEdgeCreases, size_t numVertexCreases, size_t numHoles, size_t numTimeSteps);
 
+    /*! Creates many geometries of the same type with consecutive IDs. */
+    unsigned int newGeometries (RTCGeometryType type, const RTCGeometryDescriptor* geometries, size_t numGeometries);
+
     /*! deletes some geometry */
     void deleteGeometry(size_t geomID);
 
@@ -245,6 +248,7 @@ namespace embree
     
   public:
     Device* device;
+    Ref<BlockPool> block_pool;       //!< pool of allocator blocks kept across commits
     AccelN accels;
     std::atomic<size_t> commitCounterSubdiv;
     std::atomic<size_t> numMappedBuffers;         //!< number of mapped buffers
@@ -276,6 +280,14 @@ namespace embree
     concurrency::task_group* group;
     BarrierActiveAutoReset group_barrier;
 #endif
+
+    /*! thread budget and priority of builds */
+    size_t build_threads;              //!< maximal number of threads of a build, 0 to use all threads
+    RTCBuildPriority build_priority;   //!< priority of builds
+#if USE_TASK_ARENA
+    std::unique_ptr<tbb::task_arena> build_arena; //!< arena with build_threads threads
+#endif
+    void setBuildThreads(size_t numThreads, RTCBuildPriority priority);
     
   public:
     struct BuildProgressMonitorInterface : public BuildProgressMonitor {
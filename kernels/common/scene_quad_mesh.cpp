@@ -53,6 +53,14 @@ namespace embree
     Geometry::update();
   }
 
+  void QuadMesh::setBackfaceCulling (bool enable) 
+  {
+    if (scene->isStatic() && scene->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    this->backfaceCulling = enable; 
+  }
+
   void QuadMesh::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride, size_t size) 
   { 
     if (scene->isStatic() && scene->isBuild()) 
@@ -106,6 +106,7 @@ namespace embree
     void enabling();
     void disabling();
     void setMask (unsigned mask);
+    void setBackfaceCulling (bool enable);
     void setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride, size_t size);
     void* map(RTCBufferType type);
     void unmap(RTCBufferType type);
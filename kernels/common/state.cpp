@@ -94,6 +94,11 @@ namespace embree
     object_accel_mb_max_leaf_size = 1;
 
     max_spatial_split_replications = 2.0f;
+    build_memory_limit = 0;
+    twolevel_merge_threshold = 64;
+    bvh_compaction = 0;
+    sah_calibration = false;
+    sah_calibration_file = "";
 
     tessellation_cache_size = 128*1024*1024;
 
@@ -129,6 +134,8 @@ namespace embree
     if (hasISA(AVX512KNL)) set_affinity = true;
 
     start_threads = false;
+    idle_park = true;
+    idle_spin_time = 1000;
     enable_selockmemoryprivilege = false;
 #if defined(__LINUX__)
     hugepages = true;
@@ -141,6 +148,9 @@ namespace embree
     alloc_num_main_slots = 0;
     alloc_thread_block_size = 0;
     alloc_single_thread_alloc = -1;
+    alloc_pool = true;
+    alloc_pool_shared = false;
+    alloc_pool_trim_commits = 4;
 
     error_function = nullptr;
     error_function2 = nullptr;
@@ -149,6 +159,12 @@ namespace embree
     memory_monitor_function = nullptr;
     memory_monitor_function2 = nullptr;
     memory_monitor_userptr = nullptr;
+
+    allocator_functions.alignedMalloc = nullptr;
+    allocator_functions.alignedFree = nullptr;
+    allocator_functions.pageMalloc = nullptr;
+    allocator_functions.pageFree = nullptr;
+    allocator_userptr = nullptr;
   }
 
   State::~State() {
@@ -257,6 +273,12 @@ namespace embree
       
       else if (tok == Token::Id("start_threads")&& cin->trySymbol("=")) 
         start_threads = cin->get().Int();
+
+      else if (tok == Token::Id("idle_park")&& cin->trySymbol("=")) 
+        idle_park = cin->get().Int();
+
+      else if (tok == Token::Id("idle_spin_time")&& cin->trySymbol("=")) 
+        idle_spin_time = cin->get().Int();
       
       else if (tok == Token::Id("isa") && cin->trySymbol("=")) {
         std::string isa = toLowerCase(cin->get().Identifier());
@@ -404,6 +426,17 @@ namespace embree
 
       else if (tok == Token::Id("max_spatial_split_replications") && cin->trySymbol("="))
         max_spatial_split_replications = cin->get().Float();
+      else if (tok == Token::Id("build_memory_limit") && cin->trySymbol("="))
+        build_memory_limit = size_t(cin->get().Float()*1024.0f*1024.0f);
+      else if (tok == Token::Id("twolevel_merge_threshold") && cin->trySymbol("="))
+        twolevel_merge_threshold = cin->get().Int();
+      else if (tok == Token::Id("bvh_compaction") && cin->trySymbol("="))
+        bvh_compaction = cin->get().Int();
+
+      else if (tok == Token::Id("sah_calibration") && cin->trySymbol("="))
+        sah_calibration = cin->get().Int();
+      else if (tok == Token::Id("sah_calibration_file") && cin->trySymbol("="))
+        sah_calibration_file = cin->get().String();
 
       else if (tok == Token::Id("tessellation_cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
@@ -418,6 +451,12 @@ namespace embree
          alloc_thread_block_size = cin->get().Int();
        else if (tok == Token::Id("alloc_single_thread_alloc") && cin->trySymbol("="))
          alloc_single_thread_alloc = cin->get().Int();
+       else if (tok == Token::Id("alloc_pool") && cin->trySymbol("="))
+         alloc_pool = cin->get().Int();
+       else if (tok == Token::Id("alloc_pool_shared") && cin->trySymbol("="))
+         alloc_pool_shared = cin->get().Int();
+       else if (tok == Token::Id("alloc_pool_trim_commits") && cin->trySymbol("="))
+         alloc_pool_trim_commits = cin->get().Int();
 
       cin->trySymbol(","); // optional , separator
     }
@@ -433,6 +472,7 @@ namespace embree
     std::cout << "  build threads = " << numThreads   << std::endl;
     std::cout << "  start_threads = " << start_threads << std::endl;
     std::cout << "  affinity      = " << set_affinity << std::endl;
+    std::cout << "  idle_park     = " << idle_park << " (after " << idle_spin_time << " us)" << std::endl;
     
     std::cout << "  hugepages     = ";
     if (!hugepages) std::cout << "disabled" << std::endl;
@@ -442,6 +482,12 @@ namespace embree
     std::cout << "  verbosity     = " << verbose << std::endl;
     std::cout << "  cache_size    = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  build_memory_limit = " << float(build_memory_limit)*1E-6 << " MB" << std::endl;
+    std::cout << "  twolevel_merge_threshold = " << twolevel_merge_threshold << std::endl;
+    std::cout << "  bvh_compaction = " << bvh_compaction << std::endl;
+    std::cout << "  sah_calibration = " << sah_calibration << std::endl;
+    std::cout << "  sah_calibration_file = " << sah_calibration_file << std::endl;
+    std::cout << "  alloc_pool    = " << alloc_pool << " (shared = " << alloc_pool_shared << ", trim after " << alloc_pool_trim_commits << " commits)" << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel         = " << tri_accel << std::endl;
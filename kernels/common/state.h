@@ -111,7 +111,12 @@ namespace embree
 
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
+    size_t build_memory_limit;             //!< limits the size of the primref arrays of the builders, larger scenes get build in chunks
+    size_t twolevel_merge_threshold;       //!< geometries with fewer primitives share BVHs in the two-level builder
+    int bvh_compaction;                    //!< compacts BVHs of static geometry after build, 0 = off, 1 = depth first layout, 2 = van Emde Boas layout
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
+    bool sah_calibration;                  //!< measures the SAH costs of nodes and leaves for the current CPU
+    std::string sah_calibration_file;      //!< file to load the SAH costs from and store them to
 
   public:
     size_t instancing_open_min;            //!< instancing opens tree to minimally that number of subtrees
@@ -131,6 +136,8 @@ namespace embree
     size_t numThreads;                     //!< number of threads to use in builders
     bool set_affinity;                     //!< sets affinity for worker threads
     bool start_threads;                    //!< true when threads should be started at device creation time
+    bool idle_park;                        //!< true when idle worker threads should park instead of spinning
+    size_t idle_spin_time;                 //!< time in microseconds idle worker threads spin before they park
     int enabled_cpu_features;              //!< CPU ISA features to use
     int enabled_builder_cpu_features;      //!< CPU ISA features to use for builders only
     bool enable_selockmemoryprivilege;     //!< configures the SeLockMemoryPrivilege under Windows to enable huge pages
@@ -142,6 +149,9 @@ namespace embree
     int alloc_num_main_slots;              //!< number of such shared blocks to be used to allocate
     size_t alloc_thread_block_size;        //!< size of thread local allocator block size
     int alloc_single_thread_alloc;         //!< in single mode nodes and leaves use same thread local allocator
+    bool alloc_pool;                       //!< dynamic scenes keep allocator blocks across commits
+    bool alloc_pool_shared;                //!< all scenes of the device share a single block pool
+    size_t alloc_pool_trim_commits;        //!< number of commits a pooled block has to stay unused before it gets freed
 
   public:
     struct ErrorHandler
@@ -196,5 +206,9 @@ namespace embree
     RTCMemoryMonitorFunc memory_monitor_function;
     RTCMemoryMonitorFunc2 memory_monitor_function2;
     void* memory_monitor_userptr;
+
+  public:
+    RTCAllocatorFunctions allocator_functions;   //!< allocation functions of the application, NULL entries use the default allocator
+    void* allocator_userptr;
   };
 }
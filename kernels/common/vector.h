@@ -18,9 +18,18 @@
 
 namespace embree
 {
-  /*! invokes the memory monitor callback */
-  struct MemoryMonitorInterface {
+  /*! invokes the memory monitor callback and allocates memory of the device */
+  struct MemoryMonitorInterface 
+  {
     virtual void memoryMonitor(ssize_t bytes, bool post) = 0;
+
+    /*! allocates general purpose memory */
+    virtual void* allocAligned(size_t bytes, size_t align) { return alignedMalloc(bytes,align); }
+    virtual void freeAligned(void* ptr) { alignedFree(ptr); }
+
+    /*! allocates large page granular memory blocks */
+    virtual void* allocPages(size_t bytes, bool& hugepages) { return os_malloc(bytes,hugepages); }
+    virtual void freePages(void* ptr, size_t bytes, bool hugepages) { os_free(ptr,bytes,hugepages); }
   };
 
   /*! allocator that performs aligned monitored allocations */
@@ -40,17 +49,18 @@ namespace embree
 
       __forceinline pointer allocate( size_type n ) 
       {
-        if (n) {
-          assert(device);
-          device->memoryMonitor(n*sizeof(T),false);
-        }
+        if (n == 0) 
+          return nullptr;
+
+        assert(device);
+        device->memoryMonitor(n*sizeof(T),false);
         if (n*sizeof(value_type) >= 14 * PAGE_SIZE_2M)
         {
-          pointer p =  (pointer) os_malloc(n*sizeof(value_type),hugepages);
+          pointer p =  (pointer) device->allocPages(n*sizeof(value_type),hugepages);
           assert(p);
           return p;
         }
-        return (pointer) alignedMalloc(n*sizeof(value_type),alignment);
+        return (pointer) device->allocAligned(n*sizeof(value_type),alignment);
       }
 
       __forceinline void deallocate( pointer p, size_type n ) 
@@ -58,9 +68,9 @@ namespace embree
         if (p)
         {
           if (n*sizeof(value_type) >= 14 * PAGE_SIZE_2M)
-            os_free(p,n*sizeof(value_type),hugepages); 
+            device->freePages(p,n*sizeof(value_type),hugepages); 
           else
-            alignedFree(p);
+            device->freeAligned(p);
         }
         else assert(n == 0);
 
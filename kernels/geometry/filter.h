@@ -37,10 +37,38 @@ namespace embree
   typedef void (*ISPCFilterFunc16)(void* ptr, RTCRay16& ray, __m128i valid); // mask passed as 16 bytes
 #endif
 
+    /*! Invokes a batched filter function for N potential hits stored in
+     *  RTCHitN layout. Returns the index of the nearest accepted hit, or
+     *  -1 if all hits got rejected. */
+    __forceinline ssize_t runFilterBatch1(RTCFilterFuncBatch filter, const Geometry* const geometry, const Ray& ray, IntersectContext* context, const void* hits, const size_t N)
+    {
+      assert(N <= 16);
+      int valid[16];
+      for (size_t j=0; j<N; j++) valid[j] = -1;
+      AVX_ZERO_UPPER(); filter(valid,geometry->userPtr,context->user,(const RTCRay&)ray,(const RTCHitN*)hits,N);
+      for (size_t j=0; j<N; j++) 
+        if (valid[j]) return j;
+      return -1;
+    }
+
     __forceinline bool runIntersectionFilter1(const Geometry* const geometry, Ray& ray, IntersectContext* context,
                                               const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
-      if (likely(geometry->intersectionFilter1)) // old code for compatibility
+      if (unlikely(geometry->intersectionFilterBatch))
+      {
+        const Hit hit(ray.instID,geomID,primID,u,v,t,Ng);
+        if (runFilterBatch1(geometry->intersectionFilterBatch,geometry,ray,context,&hit,1) < 0)
+          return false;
+
+        ray.u = u;
+        ray.v = v;
+        ray.tfar = t;
+        ray.geomID = geomID;
+        ray.primID = primID;
+        ray.Ng = Ng;
+        return true;
+      }
+      else if (likely(geometry->intersectionFilter1)) // old code for compatibility
       {
         /* temporarily update hit information */
 #if defined(EMBREE_INTERSECTION_FILTER_RESTORE)
@@ -82,7 +110,12 @@ namespace embree
     __forceinline bool runOcclusionFilter1(const Geometry* const geometry, Ray& ray, IntersectContext* context,
                                            const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
-      if (likely(geometry->occlusionFilter1)) // old code for compatibility
+      if (unlikely(geometry->occlusionFilterBatch))
+      {
+        const Hit hit(ray.instID,geomID,primID,u,v,t,Ng);
+        return runFilterBatch1(geometry->occlusionFilterBatch,geometry,ray,context,&hit,1) >= 0;
+      }
+      else if (likely(geometry->occlusionFilter1)) // old code for compatibility
       {
         /* temporarily update hit information */
 #if defined(EMBREE_INTERSECTION_FILTER_RESTORE)
@@ -29,6 +29,53 @@ namespace embree
         __forceinline void operator() (vfloat<M>& u, vfloat<M>& v) const {}
       };
 
+    /*! Collects the potential hits of the lanes in m that belong to the
+     *  specified geometry sorted by distance, and invokes the batched
+     *  filter function once for all of them. The collected lanes get
+     *  removed from m. Returns the lane of the nearest accepted hit, or
+     *  -1 if all hits got rejected. */
+    template<int M, typename Hit>
+      __forceinline ssize_t runFilterBatchM(RTCFilterFuncBatch filter, const Geometry* const geometry, const Ray& ray, IntersectContext* context, Hit& hit, size_t& m,
+                                            const vint<M>& geomIDs, const vint<M>& primIDs, const int geomID, const int instID)
+    {
+      /* insertion sort hits of the geometry by distance */
+      size_t lanes[16], N = 0;
+      for (size_t mi=m; mi!=0; )
+      {
+        const size_t i = __bsf(mi); mi = __btc(mi,i);
+        if (geomIDs[i] != geomID) continue;
+        m = __btc(m,i);
+#if !defined(EMBREE_BACKFACE_CULLING)
+        if (unlikely(geometry->backfaceCulling) && dot(ray.dir,hit.Ng(i)) >= 0.0f) continue;
+#endif
+        size_t j = N++;
+        for (; j>0 && hit.t(lanes[j-1]) > hit.t(i); j--) lanes[j] = lanes[j-1];
+        lanes[j] = i;
+      }
+      if (unlikely(N == 0)) return -1;
+
+      /* store hits in RTCHitN layout */
+      float hits[9*16];
+      for (size_t j=0; j<N; j++)
+      {
+        const size_t i = lanes[j];
+        const Vec3fa Ng = hit.Ng(i);
+        const Vec2f uv = hit.uv(i);
+        hits[0*N+j] = Ng.x;
+        hits[1*N+j] = Ng.y;
+        hits[2*N+j] = Ng.z;
+        ((int*)hits)[3*N+j] = ray.instID;
+        ((int*)hits)[4*N+j] = instID;
+        ((int*)hits)[5*N+j] = primIDs[i];
+        hits[6*N+j] = uv.x;
+        hits[7*N+j] = uv.y;
+        hits[8*N+j] = hit.t(i);
+      }
+      
+      const ssize_t j = runFilterBatch1(filter,geometry,ray,context,hits,N);
+      return j < 0 ? -1 : lanes[j];
+    }
+
     template<bool filter>
       struct Intersect1Epilog1
       {
@@ -215,7 +262,7 @@ namespace embree
           int geomID = geomIDs[i];
           int instID = context->geomID_to_instID ? context->geomID_to_instID[0] : geomID;
           /* intersection filter test */
-#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK)
+#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK) || !defined(EMBREE_BACKFACE_CULLING)
           bool foundhit = false;
           goto entry;
           while (true) 
@@ -236,7 +283,36 @@ namespace embree
             }
 #endif
             
+#if !defined(EMBREE_BACKFACE_CULLING)
+            /* goto next hit if the back face of a culled geometry is hit */
+            if (unlikely(geometry->backfaceCulling) && dot(ray.dir,hit.Ng(i)) >= 0.0f) {
+              clear(valid,i);
+              continue;
+            }
+#endif
+            
 #if defined(EMBREE_INTERSECTION_FILTER) 
+            /* call batched intersection filter function once for all hits of the geometry */
+            if (filter) {
+              if (unlikely(geometry->hasIntersectionFilterBatch())) {
+                size_t m = movemask(valid);
+                const ssize_t j = runFilterBatchM(geometry->intersectionFilterBatch,geometry,ray,context,hit,m,geomIDs,primIDs,geomID,instID);
+                for (size_t r=movemask(valid) & ~m; r!=0; ) { const size_t k = __bsf(r); r = __btc(r,k); clear(valid,k); }
+                if (j >= 0) {
+                  const Vec2f uv = hit.uv(j);
+                  ray.u = uv.x;
+                  ray.v = uv.y;
+                  ray.tfar = hit.t(j);
+                  ray.Ng = hit.Ng(j);
+                  ray.geomID = instID;
+                  ray.primID = primIDs[j];
+                  foundhit = true;
+                  valid &= hit.vt <= ray.tfar;
+                }
+                continue;
+              }
+            }
+
             /* call intersection filter function */
             if (filter) {
               if (unlikely(geometry->hasIntersectionFilter1())) {
@@ -295,7 +371,7 @@ namespace embree
           int instID = context->geomID_to_instID ? context->geomID_to_instID[0] : geomID;
 
           /* intersection filter test */
-#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK)
+#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK) || !defined(EMBREE_BACKFACE_CULLING)
           bool foundhit = false;
           goto entry;
           while (true) 
@@ -316,7 +392,36 @@ namespace embree
             }
 #endif
             
+#if !defined(EMBREE_BACKFACE_CULLING)
+            /* goto next hit if the back face of a culled geometry is hit */
+            if (unlikely(geometry->backfaceCulling) && dot(ray.dir,hit.Ng(i)) >= 0.0f) {
+              clear(valid,i);
+              continue;
+            }
+#endif
+            
 #if defined(EMBREE_INTERSECTION_FILTER) 
+            /* call batched intersection filter function once for all hits of the geometry */
+            if (filter) {
+              if (unlikely(geometry->hasIntersectionFilterBatch())) {
+                size_t m = movemask(valid);
+                const ssize_t j = runFilterBatchM(geometry->intersectionFilterBatch,geometry,ray,context,hit,m,geomIDs,primIDs,geomID,instID);
+                for (size_t r=movemask(valid) & ~m; r!=0; ) { const size_t k = __bsf(r); r = __btc(r,k); clear(valid,k); }
+                if (j >= 0) {
+                  const Vec2f uv = hit.uv(j);
+                  ray.u = uv.x;
+                  ray.v = uv.y;
+                  ray.tfar = hit.t(j);
+                  ray.Ng = hit.Ng(j);
+                  ray.geomID = instID;
+                  ray.primID = primIDs[j];
+                  foundhit = true;
+                  valid &= hit.vt <= ray.tfar;
+                }
+                continue;
+              }
+            }
+
             /* call intersection filter function */
             if (filter) {
               if (unlikely(geometry->hasIntersectionFilter1())) {
@@ -360,7 +465,7 @@ namespace embree
           Scene* scene = context->scene;
 
           /* intersection filter test */
-#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK)
+#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK) || !defined(EMBREE_BACKFACE_CULLING)
           if (unlikely(filter))
             hit.finalize(); /* called only once */
 
@@ -386,7 +491,26 @@ namespace embree
             }
 #endif
             
+#if !defined(EMBREE_BACKFACE_CULLING)
+            /* goto next hit if the back face of a culled geometry is hit */
+            if (unlikely(geometry->backfaceCulling)) {
+              if (!filter) hit.finalize(); /* hit normal is only available after finalize */
+              if (dot(ray.dir,hit.Ng(i)) >= 0.0f) {
+                m=__btc(m,i);
+                continue;
+              }
+            }
+#endif
+            
 #if defined(EMBREE_INTERSECTION_FILTER)
+            /* call batched occlusion filter function once for all hits of the geometry */
+            if (filter) {
+              if (unlikely(geometry->hasOcclusionFilterBatch())) {
+                if (runFilterBatchM(geometry->occlusionFilterBatch,geometry,ray,context,hit,m,geomIDs,primIDs,geomID,instID) >= 0) return true;
+                continue;
+              }
+            }
+
             /* if we have no filter then the test passed */
             if (filter) {
               if (unlikely(geometry->hasOcclusionFilter1())) 
@@ -549,6 +673,14 @@ namespace embree
           if (unlikely(none(valid))) return false;
 #endif
           
+#if !defined(EMBREE_BACKFACE_CULLING)
+          /* back face culling test */
+          if (unlikely(geometry->backfaceCulling)) {
+            valid &= dot(Ng,ray.dir) < 0.0f;
+            if (unlikely(none(valid))) return false;
+          }
+#endif
+          
           /* occlusion filter test */
 #if defined(EMBREE_INTERSECTION_FILTER)
           if (filter) {
@@ -604,6 +736,17 @@ namespace embree
           if (unlikely(none(valid))) return valid;
 #endif
           
+#if !defined(EMBREE_BACKFACE_CULLING)
+          /* back face culling test */
+          if (unlikely(geometry->backfaceCulling)) {
+            vfloat<K> u, v, t; 
+            Vec3vf<K> Ng;
+            std::tie(u,v,t,Ng) = hit();
+            valid &= dot(Ng,ray.dir) < 0.0f;
+            if (unlikely(none(valid))) return valid;
+          }
+#endif
+          
           /* intersection filter test */
 #if defined(EMBREE_INTERSECTION_FILTER)
           if (filter) {
@@ -752,7 +895,7 @@ namespace embree
           int geomID = geomIDs[i];
           
           /* intersection filter test */
-#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK)
+#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK) || !defined(EMBREE_BACKFACE_CULLING)
           bool foundhit = false;
           goto entry;
           while (true) 
@@ -772,6 +915,14 @@ namespace embree
             }
 #endif
             
+#if !defined(EMBREE_BACKFACE_CULLING)
+            /* goto next hit if the back face of a culled geometry is hit */
+            if (unlikely(geometry->backfaceCulling) && dot(Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]),hit.Ng(i)) >= 0.0f) {
+              clear(valid,i);
+              continue;
+            }
+#endif
+            
 #if defined(EMBREE_INTERSECTION_FILTER) 
             /* call intersection filter function */
             if (filter) {
@@ -828,7 +979,7 @@ namespace embree
           Scene* scene = context->scene;
 
           /* intersection filter test */
-#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK)
+#if defined(EMBREE_INTERSECTION_FILTER) || defined(EMBREE_RAY_MASK) || !defined(EMBREE_BACKFACE_CULLING)
           if (unlikely(filter))
             hit.finalize(); /* called only once */
           
@@ -853,6 +1004,17 @@ namespace embree
             }
 #endif
             
+#if !defined(EMBREE_BACKFACE_CULLING)
+            /* goto next hit if the back face of a culled geometry is hit */
+            if (unlikely(geometry->backfaceCulling)) {
+              if (!filter) hit.finalize(); /* hit normal is only available after finalize */
+              if (dot(Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]),hit.Ng(i)) >= 0.0f) {
+                m=__btc(m,i);
+                continue;
+              }
+            }
+#endif
+            
 #if defined(EMBREE_INTERSECTION_FILTER)
             /* execute occlusion filer */
             if (filter) {
@@ -73,6 +73,22 @@ namespace embree
     return ((Triangle4*)This)->size();
   }
 
+  /********************** Triangle8 **************************/
+
+  Triangle8Type::Triangle8Type ()
+    : PrimitiveType("triangle8",2*sizeof(Triangle4),8) {}
+
+  size_t Triangle8Type::size(const char* This) const
+  {
+    /* the geometry IDs follow the 8-wide v0, e1, and e2 vectors, unused slots store -1 */
+    const int* geomIDs = (const int*) (This + 9*8*sizeof(float));
+    size_t n = 0;
+    while (n<8 && geomIDs[n] != -1) n++;
+    return n;
+  }
+
+  Triangle8Type Triangle8Type::type;
+
   /********************** Triangle4v **************************/
 
   template<>
@@ -170,4 +170,22 @@ namespace embree
   typename TriangleM<M>::Type TriangleM<M>::type;
 
   typedef TriangleM<4> Triangle4;
+
+#if defined(__AVX__)
+  typedef TriangleM<8> Triangle8;
+#endif
+
+  /* 8-wide triangles can only get used in AVX code, thus their
+     primitive type is provided independent of the vfloat8 type such
+     that the BVH8 factory compiled for lower ISAs can reference it */
+  struct Triangle8Type : public PrimitiveType
+  {
+    Triangle8Type();
+    size_t size(const char* This) const;
+    static Triangle8Type type;
+  };
+
+#if defined(__AVX__)
+  static_assert(sizeof(Triangle8) == 2*sizeof(Triangle4), "Triangle8 layout does not match Triangle8Type");
+#endif
 }
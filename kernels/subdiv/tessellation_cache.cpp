@@ -23,12 +23,14 @@ namespace embree
   __thread ThreadWorkState* SharedLazyTessellationCache::init_t_state = nullptr;
   ThreadWorkState* SharedLazyTessellationCache::current_t_state = nullptr;
 
-  void resizeTessellationCache(size_t new_size)
+  void resizeTessellationCache(size_t new_size, MemoryMonitorInterface* allocator)
   {    
     if (new_size >= SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE)
       new_size = SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE;
-    if (SharedLazyTessellationCache::sharedLazyTessellationCache.getSize() != new_size) 
-      SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(new_size);    
+    if (new_size == 0) allocator = nullptr;
+    if (SharedLazyTessellationCache::sharedLazyTessellationCache.getSize() != new_size ||
+        SharedLazyTessellationCache::sharedLazyTessellationCache.getAllocator() != allocator) 
+      SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(new_size,allocator);
   }
 
   void resetTessellationCache()
@@ -42,6 +44,7 @@ namespace embree
     size = 0;
     data = nullptr;
     hugepages = false;
+    allocator = nullptr;
     maxBlocks              = size/BLOCK_SIZE;
     localTime              = NUM_CACHE_SEGMENTS;
     next_block             = 0;
@@ -178,7 +181,7 @@ namespace embree
     reset_state.unlock();
   }
 
-  void SharedLazyTessellationCache::realloc(const size_t new_size)
+  void SharedLazyTessellationCache::realloc(const size_t new_size, MemoryMonitorInterface* new_allocator)
   {
     /* lock the reset_state */
     reset_state.lock();
@@ -192,10 +195,11 @@ namespace embree
         waitForUsersLessEqual(t,THREAD_BLOCK_ATOMIC_ADD);
 
     /* reallocate data */
-    if (data) os_free(data,size,hugepages);
+    if (data) allocator->freePages(data,size,hugepages);
     size      = new_size;
     data      = nullptr;
-    if (size) data = (float*)os_malloc(size,hugepages);
+    allocator = new_allocator;
+    if (size) data = (float*)allocator->allocPages(size,hugepages);
     maxBlocks = size/BLOCK_SIZE;    
 
     /* invalidate entire cache */
@@ -22,6 +22,7 @@
 #include "../common/algorithms/parallel_for.h"
 #include <regex>
 #include <stack>
+#include <ctime>
 
 #define random  use_random_function_of_test // do use random_int() and random_float() from Test class
 #define drand48 use_random_function_of_test // do use random_int() and random_float() from Test class
@@ -1213,9 +1214,10 @@ namespace embree
     GeometryType gtype;
     RTCSceneFlags sflags;
     RTCGeometryFlags gflags;
+    bool rayMask;
     
     MemoryConsumptionTest (std::string name, int isa, GeometryType gtype, RTCSceneFlags sflags, RTCGeometryFlags gflags)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype), sflags(sflags), gflags(gflags) {}
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype), sflags(sflags), gflags(gflags), rayMask(false) {}
 
     static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
     {
@@ -1291,6 +1293,7 @@ namespace embree
     double expected_size(VerifyApplication* state, size_t NN)
     {
       double bytes_expected = expected_size_helper(state,NN);
+      if (rayMask) bytes_expected *= 1.125; // nodes additionally store geometry masks
       bool use_single_mode = false; //bytes_expected < 100000;
       double mainBlockSize = clamp(bytes_expected/20,1024.0,double(2*1024*1024-64));
       double threadLocalBlockSize = clamp(bytes_expected/20,double(1024),double(PAGE_SIZE));
@@ -1304,6 +1307,7 @@ namespace embree
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa) + ",threads="+std::to_string((long long)numThreads);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcDeviceGetError(device));
+      rayMask = rtcDeviceGetParameter1i(device,RTC_CONFIG_RAY_MASK) != 0;
       memory_consumption_bytes_used = 0;
       rtcDeviceSetMemoryMonitorFunction2(device,memoryMonitor,nullptr);
       VerifyScene scene(device,sflags,aflags);
@@ -1510,6 +1514,82 @@ namespace embree
     }
   };
 
+  struct BulkGeometryCreationTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+    RTCGeometryType type;
+
+    BulkGeometryCreationTest (std::string name, int isa, RTCSceneFlags sflags, RTCGeometryType type)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), type(type) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      VerifyScene scene(device,sflags,aflags);
+      AssertNoError(device);
+
+      /* geometry i is a unit quad or two triangles at x=2*i, all
+       * geometries share the same index and vertex buffers */
+      const size_t N = 100;
+      avector<Vec3fa> vertices(4*N);
+      for (size_t i=0; i<N; i++) {
+        vertices[4*i+0] = Vec3fa(2.0f*i+0.0f,0.0f,0.0f);
+        vertices[4*i+1] = Vec3fa(2.0f*i+1.0f,0.0f,0.0f);
+        vertices[4*i+2] = Vec3fa(2.0f*i+1.0f,0.0f,1.0f);
+        vertices[4*i+3] = Vec3fa(2.0f*i+0.0f,0.0f,1.0f);
+      }
+      const int triangles[6] = { 0,1,2, 0,2,3 };
+      const int quads[4] = { 0,1,2,3 };
+
+      std::vector<RTCBufferDescriptor> buffers(2*N);
+      std::vector<RTCGeometryDescriptor> geometries(N);
+      for (size_t i=0; i<N; i++)
+      {
+        if (type == RTC_GEOMETRY_TYPE_QUAD_MESH) {
+          buffers[2*i+0] = { RTC_INDEX_BUFFER, quads, 0, 4*sizeof(int), 1 };
+          geometries[i] = { RTC_GEOMETRY_STATIC, 1, 4, 1, &buffers[2*i], 2 };
+        } else {
+          buffers[2*i+0] = { RTC_INDEX_BUFFER, triangles, 0, 3*sizeof(int), 2 };
+          geometries[i] = { RTC_GEOMETRY_STATIC, 2, 4, 1, &buffers[2*i], 2 };
+        }
+        buffers[2*i+1] = { RTC_VERTEX_BUFFER, vertices.data(), 4*i*sizeof(Vec3fa), sizeof(Vec3fa), 4 };
+      }
+
+      /* an ID used before has to get skipped */
+      unsigned geomID0 = rtcNewTriangleMesh(scene,RTC_GEOMETRY_STATIC,0,0,1);
+      AssertNoError(device);
+
+      /* a single invalid buffer lets the entire creation fail */
+      buffers[2*(N/2)+1].byteOffset++;
+      unsigned geomID = rtcNewGeometries(scene,type,geometries.data(),N);
+      AssertError(device,RTC_INVALID_OPERATION);
+      if (geomID != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+      buffers[2*(N/2)+1].byteOffset--;
+
+      geomID = rtcNewGeometries(scene,type,geometries.data(),N);
+      AssertNoError(device);
+      if (geomID != geomID0+1) return VerifyApplication::FAILED;
+
+      /* the next geometry has to get the ID after the created ones */
+      unsigned geomID1 = rtcNewTriangleMesh(scene,RTC_GEOMETRY_STATIC,0,0,1);
+      AssertNoError(device);
+      if (geomID1 != geomID+N) return VerifyApplication::FAILED;
+
+      rtcCommit(scene);
+      AssertNoError(device);
+
+      for (size_t i=0; i<N; i++)
+      {
+        RTCRay ray = makeRay(Vec3fa(2.0f*i+0.5f,1.0f,0.5f),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        if (ray.geomID != geomID+i) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct EnableDisableGeometryTest : public VerifyApplication::Test
   {
     RTCSceneFlags sflags;
@@ -2359,6 +2439,719 @@ namespace embree
     }
   };
 
+  struct GeometryBackfaceCullingTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+    GeometryType gtype;
+
+    GeometryBackfaceCullingTest (std::string name, int isa, RTCSceneFlags sflags, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+       
+      /* create two planes next to each other that are front facing when
+         looking along the z direction, only the first one culls back faces */
+      VerifyScene scene(device,sflags,to_aflags(imode));
+      AssertNoError(device);
+      const Vec3fa p0 = Vec3fa(0.0f);
+      const Vec3fa p1 = Vec3fa(1.0f,0.0f,0.0f);
+      const Vec3fa dx = Vec3fa(1.0f,0.0f,0.0f);
+      const Vec3fa dy = Vec3fa(0.0f,1.0f,0.0f);
+      unsigned geom0 = -1, geom1 = -1;
+      switch (gtype) {
+      case TRIANGLE_MESH:    
+        geom0 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)); 
+        geom1 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTrianglePlane(p1,dx,dy,1,1)); 
+        break;
+      case TRIANGLE_MESH_MB: 
+        geom0 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)->set_motion_vector(Vec3fa(0.0f,0.0f,0.1f))); 
+        geom1 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTrianglePlane(p1,dx,dy,1,1)->set_motion_vector(Vec3fa(0.0f,0.0f,0.1f))); 
+        break;
+      case QUAD_MESH:        
+        geom0 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadPlane(p0,dx,dy,1,1)); 
+        geom1 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadPlane(p1,dx,dy,1,1)); 
+        break;
+      case QUAD_MESH_MB:     
+        geom0 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadPlane(p0,dx,dy,1,1)->set_motion_vector(Vec3fa(0.0f,0.0f,0.1f))); 
+        geom1 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadPlane(p1,dx,dy,1,1)->set_motion_vector(Vec3fa(0.0f,0.0f,0.1f))); 
+        break;
+      default:               throw std::runtime_error("unsupported geometry type: "+to_string(gtype)); 
+      }
+      rtcSetBackfaceCulling(scene,geom0,true);
+      
+      AssertNoError(device);
+      rtcCommit (scene);
+      AssertNoError(device);
+
+      const size_t numRays = 1000;
+      RTCRay rays[numRays];
+      bool passed = true;
+
+      for (size_t i=0; i<numRays; i++) {
+        const float rx = 2.0f*random_float();
+        const float ry = random_float();
+        if (i%2) rays[i] = makeRay(Vec3fa(rx,ry,+1),Vec3fa(0,0,-1)); 
+        else     rays[i] = makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,+1)); 
+      }
+      
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
+      
+      for (size_t i=0; i<numRays; i++) 
+      {
+        const bool culled = rays[i].org[0] < 1.0f;
+        const bool hit = rays[i].geomID != RTC_INVALID_GEOMETRY_ID;
+        if (i%2) passed &= hit == !culled;
+        else     passed &= hit;
+        if (hit && (ivariant & VARIANT_INTERSECT))
+          passed &= rays[i].geomID == (culled ? geom0 : geom1);
+      }
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct MotionBlurSpatialSplitTest : public VerifyApplication::IntersectTest
+  {
+    GeometryType gtype;
+
+    MotionBlurSpatialSplitTest (std::string name, int isa, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* create long thin moving strips, once with and once without spatial splits */
+      VerifyScene scene0(device,RTC_SCENE_STATIC,to_aflags(imode));
+      VerifyScene scene1(device,RTC_SCENE_STATIC | RTC_SCENE_HIGH_QUALITY,to_aflags(imode));
+      AssertNoError(device);
+      for (size_t i=0; i<100; i++)
+      {
+        const Vec3fa p = 10.0f*random_Vec3fa();
+        const Vec3fa dx = Vec3fa(10.0f)+random_Vec3fa();
+        const Vec3fa dy = 0.1f*(random_Vec3fa()-Vec3fa(0.5f));
+        const avector<Vec3fa> motion_vector = random_motion_vector(0.5f);
+        Ref<SceneGraph::Node> node;
+        switch (gtype) {
+        case TRIANGLE_MESH_MB: node = SceneGraph::createTrianglePlane(p,dx,dy,1,1)->set_motion_vector(motion_vector); break;
+        case QUAD_MESH_MB    : node = SceneGraph::createQuadPlane(p,dx,dy,1,1)->set_motion_vector(motion_vector); break;
+        default:               throw std::runtime_error("unsupported geometry type: "+to_string(gtype)); 
+        }
+        scene0.addGeometry(RTC_GEOMETRY_STATIC,node);
+        scene1.addGeometry(RTC_GEOMETRY_STATIC,node);
+      }
+      AssertNoError(device);
+      rtcCommit (scene0);
+      rtcCommit (scene1);
+      AssertNoError(device);
+
+      const size_t numRays = 1000;
+      RTCRay rays0[numRays];
+      RTCRay rays1[numRays];
+      for (size_t i=0; i<numRays; i++) {
+        rays0[i] = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+        rays0[i].time = random_float();
+        rays1[i] = rays0[i];
+      }
+
+      IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+      IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+
+      /* both BVHs have to find the same hits */
+      bool passed = true;
+      for (size_t i=0; i<numRays; i++) 
+      {
+        passed &= rays0[i].geomID == rays1[i].geomID;
+        if (rays0[i].geomID != RTC_INVALID_GEOMETRY_ID && (ivariant & VARIANT_INTERSECT)) {
+          passed &= rays0[i].primID == rays1[i].primID;
+          passed &= rays0[i].tfar == rays1[i].tfar;
+        }
+      }
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct ChunkedBuildTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+
+    ChunkedBuildTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* the second device builds in chunks of about 300 primitives */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg_chunked = cfg + ",build_memory_limit=0.01";
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg_chunked.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device1));
+      if (!supportsIntersectMode(device0,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene0(device0,sflags,to_aflags(imode));
+      VerifyScene scene1(device1,sflags,to_aflags(imode));
+      for (size_t i=0; i<50; i++)
+      {
+        const Vec3fa p = 10.0f*random_Vec3fa();
+        const Vec3fa dx = 2.0f*(random_Vec3fa()-Vec3fa(0.5f));
+        const Vec3fa dy = 2.0f*(random_Vec3fa()-Vec3fa(0.5f));
+        Ref<SceneGraph::Node> node = i%2 ? 
+          (Ref<SceneGraph::Node>) SceneGraph::createTrianglePlane(p,dx,dy,8,8) : 
+          (Ref<SceneGraph::Node>) SceneGraph::createQuadPlane(p,dx,dy,8,8);
+        scene0.addGeometry(RTC_GEOMETRY_STATIC,node);
+        scene1.addGeometry(RTC_GEOMETRY_STATIC,node);
+      }
+      rtcCommit (scene0);
+      rtcCommit (scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      const size_t numRays = 1000;
+      RTCRay rays0[numRays];
+      RTCRay rays1[numRays];
+      for (size_t i=0; i<numRays; i++) {
+        rays0[i] = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+        rays1[i] = rays0[i];
+      }
+
+      IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+      IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+
+      /* both BVHs have to find the same hits */
+      bool passed = true;
+      for (size_t i=0; i<numRays; i++) 
+      {
+        passed &= rays0[i].geomID == rays1[i].geomID;
+        if (rays0[i].geomID != RTC_INVALID_GEOMETRY_ID && (ivariant & VARIANT_INTERSECT)) {
+          passed &= rays0[i].primID == rays1[i].primID;
+          passed &= rays0[i].tfar == rays1[i].tfar;
+        }
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct MergedGeometryTest : public VerifyApplication::IntersectTest
+  {
+    RTCGeometryFlags gflags;
+
+    MergedGeometryTest (std::string name, int isa, RTCGeometryFlags gflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), gflags(gflags) {}
+
+    Ref<SceneGraph::Node> createPlane(size_t i, size_t size)
+    {
+      const Vec3fa p = 10.0f*random_Vec3fa();
+      const Vec3fa dx = 2.0f*(random_Vec3fa()-Vec3fa(0.5f));
+      const Vec3fa dy = 2.0f*(random_Vec3fa()-Vec3fa(0.5f));
+      return i%2 ? 
+        (Ref<SceneGraph::Node>) SceneGraph::createTrianglePlane(p,dx,dy,size,size) : 
+        (Ref<SceneGraph::Node>) SceneGraph::createQuadPlane(p,dx,dy,size,size);
+    }
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* the first device merges small geometries, the second one does not */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg_unmerged = cfg + ",twolevel_merge_threshold=0";
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg_unmerged.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device1));
+      if (!supportsIntersectMode(device0,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene0(device0,RTC_SCENE_DYNAMIC,to_aflags(imode));
+      VerifyScene scene1(device1,RTC_SCENE_DYNAMIC,to_aflags(imode));
+
+      auto addGeometry = [&] (size_t i) {
+        Ref<SceneGraph::Node> node = createPlane(i,i%50 ? 2 : 16);
+        scene0.addGeometry(gflags,node);
+        scene1.addGeometry(gflags,node);
+      };
+
+      /* both BVHs have to find the same hits */
+      auto compare = [&] () -> bool
+      {
+        const size_t numRays = 1000;
+        RTCRay rays0[numRays];
+        RTCRay rays1[numRays];
+        for (size_t i=0; i<numRays; i++) {
+          rays0[i] = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+          rays1[i] = rays0[i];
+        }
+        
+        IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+        IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+
+        bool passed = true;
+        for (size_t i=0; i<numRays; i++) 
+        {
+          passed &= rays0[i].geomID == rays1[i].geomID;
+          if (rays0[i].geomID != RTC_INVALID_GEOMETRY_ID && (ivariant & VARIANT_INTERSECT)) {
+            passed &= rays0[i].primID == rays1[i].primID;
+            passed &= rays0[i].tfar == rays1[i].tfar;
+          }
+        }
+        return passed;
+      };
+
+      /* many small and some large geometries */
+      for (size_t i=0; i<200; i++) 
+        addGeometry(i);
+      rtcCommit (scene0);
+      rtcCommit (scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+      bool passed = compare();
+
+      /* changing the set of small geometries regroups them */
+      for (unsigned i=0; i<200; i+=7) {
+        rtcDeleteGeometry(scene0,i);
+        rtcDeleteGeometry(scene1,i);
+      }
+      for (unsigned i=3; i<200; i+=11) {
+        if (i%7 == 0) continue;
+        rtcDisable(scene0,i);
+        rtcDisable(scene1,i);
+      }
+      for (size_t i=0; i<20; i++)
+        addGeometry(i);
+      rtcCommit (scene0);
+      rtcCommit (scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+      passed &= compare();
+
+      /* unchanged small geometries keep their shared BVHs */
+      rtcCommit (scene0);
+      rtcCommit (scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+      passed &= compare();
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct BuildThreadsTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+    size_t numThreads;
+    RTCBuildPriority priority;
+
+    BuildThreadsTest (std::string name, int isa, RTCSceneFlags sflags, size_t numThreads, RTCBuildPriority priority)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), numThreads(numThreads), priority(priority) {}
+
+    static void commitThread(void* scene) {
+      rtcCommit((RTCScene)scene);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      VerifyScene scene0(device,sflags,aflags);
+      VerifyScene scene1(device,sflags,aflags);
+      AssertNoError(device);
+
+      rtcSetBuildThreads(scene0,numThreads,RTCBuildPriority(7));
+      AssertError(device,RTC_INVALID_ARGUMENT);
+      rtcSetBuildThreads(scene0,numThreads,priority);
+      AssertNoError(device);
+      const RTCBuildPriority otherPriority = priority == RTC_BUILD_PRIORITY_HIGH ? RTC_BUILD_PRIORITY_LOW : RTC_BUILD_PRIORITY_HIGH;
+      rtcSetBuildThreads(scene1,0,otherPriority);
+      AssertNoError(device);
+
+      for (size_t i=0; i<20; i++) {
+        Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(10.0f*random_Vec3fa(),1.0f,50);
+        scene0.addGeometry(RTC_GEOMETRY_STATIC,node);
+        scene1.addGeometry(RTC_GEOMETRY_STATIC,node);
+      }
+
+      /* build scene with limited threads concurrently to the other scene */
+      thread_t thread = createThread(commitThread,(RTCScene)scene0);
+      rtcCommit(scene1);
+      join(thread);
+      AssertNoError(device);
+
+      /* both scenes have to find the same hits */
+      for (size_t i=0; i<1000; i++)
+      {
+        RTCRay ray0 = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+        RTCRay ray1 = ray0;
+        rtcIntersect(scene0,ray0);
+        rtcIntersect(scene1,ray1);
+        if (ray0.geomID != ray1.geomID || ray0.primID != ray1.primID || ray0.tfar != ray1.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BlockPoolTest : public VerifyApplication::Test
+  {
+    std::string poolcfg;
+
+    BlockPoolTest (std::string name, int isa, std::string poolcfg)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), poolcfg(poolcfg) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+","+poolcfg;
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      VerifyScene scene0(device,RTC_SCENE_DYNAMIC,aflags);
+      AssertNoError(device);
+
+      std::vector<unsigned> geomIDs;
+      for (size_t frame=0; frame<16; frame++)
+      {
+        /* the geometries change their size each frame, thus the dynamic scene rebuilds from pooled blocks */
+        for (auto geomID : geomIDs)
+          rtcDeleteGeometry(scene0,geomID);
+        geomIDs.clear();
+
+        /* the static reference scene does not use the pool */
+        VerifyScene scene1(device,RTC_SCENE_STATIC,aflags);
+        for (size_t i=0; i<1+frame%5; i++) {
+          Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(10.0f*random_Vec3fa(),1.0f,10+random_int()%40);
+          geomIDs.push_back(scene0.addGeometry(RTC_GEOMETRY_DYNAMIC,node));
+          scene1.addGeometry(RTC_GEOMETRY_STATIC,node);
+        }
+        rtcCommit(scene0);
+        rtcCommit(scene1);
+        AssertNoError(device);
+
+        /* both scenes have to find the same hits */
+        for (size_t i=0; i<100; i++)
+        {
+          RTCRay ray0 = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+          RTCRay ray1 = ray0;
+          rtcIntersect(scene0,ray0);
+          rtcIntersect(scene1,ray1);
+          if (ray1.geomID != RTC_INVALID_GEOMETRY_ID) ray1.geomID = geomIDs[ray1.geomID];
+          if (ray0.geomID != ray1.geomID || ray0.primID != ray1.primID || ray0.tfar != ray1.tfar)
+            return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct AllocatorFunctionsTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+    std::atomic<ssize_t> numAligned;
+    std::atomic<ssize_t> numPages;
+    std::atomic<size_t> numAlignedTotal;
+
+    AllocatorFunctionsTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), numAligned(0), numPages(0), numAlignedTotal(0) {}
+
+    static void* alignedMallocFunc(void* userPtr, size_t bytes, size_t align) 
+    {
+      AllocatorFunctionsTest* This = (AllocatorFunctionsTest*) userPtr;
+      void* ptr = alignedMalloc(bytes,align);
+      if (ptr) { This->numAligned++; This->numAlignedTotal++; }
+      return ptr;
+    }
+
+    static void alignedFreeFunc(void* userPtr, void* ptr) 
+    {
+      AllocatorFunctionsTest* This = (AllocatorFunctionsTest*) userPtr;
+      This->numAligned--;
+      alignedFree(ptr);
+    }
+
+    static void* pageMallocFunc(void* userPtr, size_t bytes, bool* hugePages) 
+    {
+      AllocatorFunctionsTest* This = (AllocatorFunctionsTest*) userPtr;
+      void* ptr = alignedMalloc(bytes,4096);
+      if (ptr) This->numPages++;
+      *hugePages = false;
+      return ptr;
+    }
+
+    static void pageFreeFunc(void* userPtr, void* ptr, size_t bytes, bool hugePages) 
+    {
+      AllocatorFunctionsTest* This = (AllocatorFunctionsTest*) userPtr;
+      This->numPages--;
+      alignedFree(ptr);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCAllocatorFunctions funcs = { alignedMallocFunc, alignedFreeFunc, pageMallocFunc, pageFreeFunc };
+      {
+        RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcDeviceGetError(device));
+
+        /* allocation and free functions have to get set together */
+        RTCAllocatorFunctions invalid = { alignedMallocFunc, nullptr, nullptr, nullptr };
+        rtcDeviceSetAllocatorFunctions(device,&invalid,this);
+        AssertError(device,RTC_INVALID_ARGUMENT);
+        rtcDeviceSetAllocatorFunctions(device,&funcs,this);
+        AssertNoError(device);
+
+        /* the reference scene uses the default allocator */
+        RTCDeviceRef device1 = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcDeviceGetError(device1));
+        {
+          VerifyScene scene0(device,sflags,aflags);
+          VerifyScene scene1(device1,sflags,aflags);
+          AssertNoError(device);
+
+          RandomSampler sampler;
+          RandomSampler_init(sampler,0);
+          for (size_t i=0; i<4; i++) {
+            Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(10.0f*random_Vec3fa(),1.0f,10+i*50);
+            scene0.addGeometry(RTC_GEOMETRY_STATIC,node);
+            scene1.addGeometry(RTC_GEOMETRY_STATIC,node);
+          }
+          Ref<SceneGraph::Node> hair = SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),Vec3fa(0.0f),Vec3fa(10.0f,0.0f,0.0f),Vec3fa(0.0f,10.0f,0.0f),0.1f,0.01f,100,SceneGraph::HairSetNode::HAIR);
+          scene0.addGeometry(RTC_GEOMETRY_STATIC,hair);
+          scene1.addGeometry(RTC_GEOMETRY_STATIC,hair);
+          rtcCommit(scene0);
+          rtcCommit(scene1);
+          AssertNoError(device);
+          AssertNoError(device1);
+
+          /* functions cannot change while the device has memory allocated */
+          rtcDeviceSetAllocatorFunctions(device,nullptr,nullptr);
+          AssertError(device,RTC_INVALID_OPERATION);
+
+          /* both scenes have to find the same hits */
+          for (size_t i=0; i<1000; i++)
+          {
+            RTCRay ray0 = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+            RTCRay ray1 = ray0;
+            rtcIntersect(scene0,ray0);
+            rtcIntersect(scene1,ray1);
+            if (ray0.geomID != ray1.geomID || ray0.primID != ray1.primID || ray0.tfar != ray1.tfar)
+              return VerifyApplication::FAILED;
+          }
+        }
+        AssertNoError(device);
+      }
+
+      /* all memory got allocated and freed through the functions */
+      if (numAlignedTotal == 0 || numAligned != 0 || numPages != 0)
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BVHCompactionTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    BVHCompactionTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static bool monitorMemoryFunc(void* userPtr, ssize_t bytes, bool post) 
+    {
+      std::atomic<ssize_t>* bytesUsed = (std::atomic<ssize_t>*) userPtr;
+      *bytesUsed += bytes;
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* the same scene without compaction, with depth first, and with van Emde Boas layout */
+      std::atomic<ssize_t> bytesUsed[3];
+      RTCDeviceRef device[3];
+      Ref<VerifyScene> scene[3];
+      for (size_t i=0; i<3; i++) 
+      {
+        bytesUsed[i] = 0;
+        std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",bvh_compaction="+toString(i);
+        device[i] = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcDeviceGetError(device[i]));
+        rtcDeviceSetMemoryMonitorFunction2(device[i],monitorMemoryFunc,&bytesUsed[i]);
+        scene[i] = new VerifyScene(device[i],sflags,aflags);
+      }
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler,0);
+      std::vector<Ref<SceneGraph::Node>> nodes;
+      for (size_t i=0; i<4; i++) {
+        const Vec3fa center = 10.0f*random_Vec3fa();
+        nodes.push_back(SceneGraph::createTriangleSphere(center,1.0f,10+i*40));
+        nodes.push_back(SceneGraph::createQuadSphere(center+Vec3fa(1.0f),1.0f,10+i*40)->set_motion_vector(random_motion_vector(1.0f)));
+        nodes.push_back(SceneGraph::createSubdivSphere(center+Vec3fa(2.0f),1.0f,8,4));
+        nodes.push_back(SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),center,Vec3fa(1,0,0),Vec3fa(0,1,0),0.1f,0.01f,100,SceneGraph::HairSetNode::HAIR));
+      }
+      for (size_t i=0; i<3; i++) {
+        for (auto node : nodes) scene[i]->addGeometry(RTC_GEOMETRY_STATIC,node);
+        rtcCommit(*scene[i]);
+        AssertNoError(device[i]);
+      }
+
+      /* compaction does not increase the memory consumption */
+      if (bytesUsed[1] > bytesUsed[0] || bytesUsed[2] > bytesUsed[0])
+        return VerifyApplication::FAILED;
+
+      /* all scenes have to find the same hits */
+      for (size_t i=0; i<1000; i++)
+      {
+        RTCRay ray[3];
+        ray[0] = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+        ray[0].time = random_float();
+        for (size_t j=0; j<3; j++) {
+          ray[j] = ray[0];
+          rtcIntersect(*scene[j],ray[j]);
+        }
+        for (size_t j=1; j<3; j++)
+          if (ray[j].geomID != ray[0].geomID || ray[j].primID != ray[0].primID || ray[j].tfar != ray[0].tfar)
+            return VerifyApplication::FAILED;
+      }
+      for (size_t i=0; i<3; i++)
+        AssertNoError(device[i]);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct ExternalTaskingTest : public VerifyApplication::Test
+  {
+    static const size_t NUM_THREADS = 4;
+    static __thread ssize_t poolThreadIndex;
+
+    RTCSceneFlags sflags;
+    std::atomic<size_t> numTasks;
+    std::atomic<bool> invalidThreadIndex;
+
+    ExternalTaskingTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), numTasks(0), invalidThreadIndex(false) {}
+
+    /* simple tasking system that executes tasks with some threads */
+    struct TaskSet
+    {
+      ExternalTaskingTest* test;
+      RTCTaskFunc func;
+      void* taskPtr;
+      size_t taskCount;
+      std::atomic<size_t> next;
+    };
+
+    struct PoolThread
+    {
+      TaskSet* set;
+      size_t threadIndex;
+    };
+
+    static void runTasks(TaskSet* set, size_t threadIndex)
+    {
+      const ssize_t oldThreadIndex = poolThreadIndex;
+      poolThreadIndex = threadIndex;
+      for (size_t i=set->next++; i<set->taskCount; i=set->next++) {
+        if (threadIndex >= NUM_THREADS) set->test->invalidThreadIndex = true;
+        set->func(set->taskPtr,threadIndex,i);
+        set->test->numTasks++;
+      }
+      poolThreadIndex = oldThreadIndex;
+    }
+
+    static void poolThread(void* ptr) {
+      PoolThread* thread = (PoolThread*) ptr;
+      runTasks(thread->set,thread->threadIndex);
+    }
+
+    static void parallelFor(void* userPtr, RTCTaskFunc func, void* taskPtr, size_t taskCount)
+    {
+      TaskSet set;
+      set.test = (ExternalTaskingTest*) userPtr;
+      set.func = func;
+      set.taskPtr = taskPtr;
+      set.taskCount = taskCount;
+      set.next = 0;
+
+      /* nested task sets are executed by the calling thread of the pool */
+      if (poolThreadIndex >= 0) {
+        runTasks(&set,poolThreadIndex);
+        return;
+      }
+
+      PoolThread threadData[NUM_THREADS];
+      std::vector<thread_t> threads;
+      for (size_t i=0; i<NUM_THREADS; i++) {
+        threadData[i].set = &set;
+        threadData[i].threadIndex = i;
+        if (i) threads.push_back(createThread(poolThread,&threadData[i]));
+      }
+      runTasks(&set,0);
+      for (auto thread : threads) join(thread);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      VerifyScene scene0(device,sflags,aflags);
+      VerifyScene scene1(device,sflags,aflags);
+      AssertNoError(device);
+
+      for (size_t i=0; i<20; i++) {
+        Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(10.0f*random_Vec3fa(),1.0f,50);
+        scene0.addGeometry(RTC_GEOMETRY_STATIC,node);
+        scene1.addGeometry(RTC_GEOMETRY_STATIC,node);
+      }
+      rtcCommit(scene0);
+      AssertNoError(device);
+
+      rtcDeviceSetParallelForFunction(device,parallelFor,this,0);
+      AssertError(device,RTC_INVALID_ARGUMENT);
+      rtcDeviceSetParallelForFunction(device,parallelFor,this,NUM_THREADS);
+      if (rtcDeviceGetError(device) == RTC_INVALID_OPERATION) 
+        return VerifyApplication::SKIPPED;
+
+      /* build second scene with tasking system of the application */
+      rtcCommit(scene1);
+      rtcDeviceSetParallelForFunction(device,nullptr,nullptr,0);
+      AssertNoError(device);
+      if (numTasks == 0 || invalidThreadIndex)
+        return VerifyApplication::FAILED;
+
+      /* both scenes have to find the same hits */
+      for (size_t i=0; i<1000; i++)
+      {
+        RTCRay ray0 = makeRay(10.0f*random_Vec3fa(),random_Vec3fa()-Vec3fa(0.5f));
+        RTCRay ray1 = ray0;
+        rtcIntersect(scene0,ray0);
+        rtcIntersect(scene1,ray1);
+        if (ray0.geomID != ray1.geomID || ray0.primID != ray1.primID || ray0.tfar != ray1.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  __thread ssize_t ExternalTaskingTest::poolThreadIndex = -1;
+
   struct IntersectionFilterTest : public VerifyApplication::IntersectTest
   {
     RTCSceneFlags sflags;
@@ -2517,6 +3310,84 @@ namespace embree
     }
   };
     
+  struct IntersectionFilterBatchTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+
+    IntersectionFilterBatchTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+    
+    /* rejects all hits of the first two planes and checks that hits are sorted by distance */
+    static void intersectionFilterBatch(int* valid,
+                                        void* userGeomPtr,
+                                        const RTCIntersectContext* context,
+                                        const RTCRay& ray,
+                                        const RTCHitN* potentialHits,
+                                        const size_t N)
+    {
+      bool* sorted = (bool*) userGeomPtr;
+      for (size_t i=0; i<N; i++)
+      {
+        if (i > 0 && RTCHitN_t(potentialHits,N,i) < RTCHitN_t(potentialHits,N,i-1)) 
+          *sorted = false;
+        
+        if (RTCHitN_primID(potentialHits,N,i) < 4) 
+          valid[i] = 0;
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* create 4 stacked planes at z=-1,-2,-3,-4 inside a single mesh */
+      VerifyScene scene(device,sflags,to_aflags(imode));
+      unsigned geom0 = rtcNewTriangleMesh (scene, RTC_GEOMETRY_STATIC, 8, 16);
+      Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+      Triangle* triangles = (Triangle*) rtcMapBuffer(scene,geom0,RTC_INDEX_BUFFER);
+      for (int i=0; i<4; i++)
+      {
+        const float z = -float(i+1);
+        vertices[4*i+0] = Vec3fa(-1.0f,-1.0f,z);
+        vertices[4*i+1] = Vec3fa(+1.0f,-1.0f,z);
+        vertices[4*i+2] = Vec3fa(+1.0f,+1.0f,z);
+        vertices[4*i+3] = Vec3fa(-1.0f,+1.0f,z);
+        triangles[2*i+0] = Triangle(4*i+0,4*i+1,4*i+2);
+        triangles[2*i+1] = Triangle(4*i+0,4*i+2,4*i+3);
+      }
+      rtcUnmapBuffer(scene,geom0,RTC_VERTEX_BUFFER);
+      rtcUnmapBuffer(scene,geom0,RTC_INDEX_BUFFER);
+      
+      bool sorted = true;
+      rtcSetUserData(scene,geom0,&sorted);
+      rtcSetIntersectionFilterFunctionBatch(scene,geom0,intersectionFilterBatch);
+      rtcSetOcclusionFilterFunctionBatch   (scene,geom0,intersectionFilterBatch);
+      rtcCommit (scene);
+      AssertNoError(device);
+
+      /* the first ray sees all planes, the second one only the rejected second plane */
+      RTCRay rays[2];
+      rays[0] = makeRay(Vec3fa(0.1f,0.2f,0.0f),Vec3fa(0,0,-1));
+      rays[1] = makeRay(Vec3fa(0.1f,0.2f,-1.5f),Vec3fa(0,0,-1),0.0f,1.0f);
+      IntersectWithMode(imode,ivariant,scene,rays,2);
+      
+      bool passed = sorted;
+      passed &= rays[0].geomID == geom0;
+      passed &= rays[1].geomID == RTC_INVALID_GEOMETRY_ID;
+      if (ivariant & VARIANT_INTERSECT) {
+        passed &= rays[0].primID == 4 || rays[0].primID == 5;
+        passed &= abs(rays[0].tfar-3.0f) < 1E-4f;
+      }
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+    
   struct InactiveRaysTest : public VerifyApplication::IntersectTest
   {
     RTCSceneFlags sflags;
@@ -3533,6 +4404,57 @@ namespace embree
     }
   };
   
+  struct TaskingBenchmark : public VerifyApplication::Benchmark
+  {
+    size_t blockSize;
+
+    TaskingBenchmark (std::string name, int isa, size_t blockSize)
+      : VerifyApplication::Benchmark(name,isa,"Mtasks/s",true,10), blockSize(blockSize) {}
+    
+    float benchmark(VerifyApplication* state)
+    {
+      const size_t N = 1024*1024;
+      std::atomic<size_t> sum(0);
+      double t0 = getSeconds();
+      parallel_for(size_t(0),N,blockSize,[&](const range<size_t>& r) {
+          size_t s = 0;
+          for (size_t i=r.begin(); i<r.end(); i++) s += i;
+          sum += s;
+        });
+      double t1 = getSeconds();
+      if (sum != N*(N-1)/2) return 0.0f;
+      return 1E-6f*float(N/blockSize)/float(t1-t0);
+    }
+  };
+
+  struct TaskingIdleBenchmark : public VerifyApplication::Benchmark
+  {
+    bool measureCPU;
+
+    TaskingIdleBenchmark (std::string name, int isa, bool measureCPU)
+      : VerifyApplication::Benchmark(name,isa,measureCPU ? "cores" : "us",false,10), measureCPU(measureCPU) {}
+
+    float benchmark(VerifyApplication* state)
+    {
+      /* a single long running task leaves all other worker threads idle */
+      const std::clock_t c0 = std::clock();
+      const double t0 = getSeconds();
+      parallel_for(size_t(1),[&](size_t i) { sleepSeconds(0.02); });
+      const double t1 = getSeconds();
+      const std::clock_t c1 = std::clock();
+      if (measureCPU)
+        return float(double(c1-c0)/double(CLOCKS_PER_SEC))/float(t1-t0);
+
+      /* measures how long it takes to get the idle threads working again */
+      std::atomic<size_t> sum(0);
+      const double t2 = getSeconds();
+      parallel_for(size_t(0),size_t(1024),[&](const range<size_t>& r) { sum += r.size(); });
+      const double t3 = getSeconds();
+      if (sum != 1024) return float(inf);
+      return 1E6f*float(t3-t2);
+    }
+  };
+
   struct ParallelIntersectBenchmark : public VerifyApplication::Benchmark
   {
     unsigned int N, dN;
@@ -3570,6 +4492,7 @@ namespace embree
     IntersectMode imode;
     IntersectVariant ivariant;
     size_t numPhi;
+    std::string tri_accel;
     RTCDeviceRef device;
     Ref<VerifyScene> scene;
 	static const size_t tileSizeX = 32;
@@ -3579,8 +4502,8 @@ namespace embree
 	static const size_t numTilesX = width / tileSizeX;
 	static const size_t numTilesY = height / tileSizeY;
     
-    CoherentRaysBenchmark (std::string name, int isa, GeometryType gtype, RTCSceneFlags sflags, RTCGeometryFlags gflags, IntersectMode imode, IntersectVariant ivariant, size_t numPhi)
-      : ParallelIntersectBenchmark(name,isa,numTilesX*numTilesY,1), gtype(gtype), sflags(sflags), gflags(gflags), imode(imode), ivariant(ivariant), numPhi(numPhi) {}
+    CoherentRaysBenchmark (std::string name, int isa, GeometryType gtype, RTCSceneFlags sflags, RTCGeometryFlags gflags, IntersectMode imode, IntersectVariant ivariant, size_t numPhi, std::string tri_accel = "")
+      : ParallelIntersectBenchmark(name,isa,numTilesX*numTilesY,1), gtype(gtype), sflags(sflags), gflags(gflags), imode(imode), ivariant(ivariant), numPhi(numPhi), tri_accel(tri_accel) {}
     
     size_t setNumPrimitives(size_t N) 
     { 
@@ -3594,6 +4517,7 @@ namespace embree
         return false;
 
       std::string cfg = state->rtcore + ",start_threads=1,set_affinity=1,isa="+stringOfISA(isa);
+      if (tri_accel != "") cfg += ",tri_accel="+tri_accel;
       device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcDeviceGetError(device));
       rtcDeviceSetErrorFunction2(device,errorHandler,nullptr);
@@ -3746,13 +4670,14 @@ namespace embree
     IntersectMode imode;
     IntersectVariant ivariant;
     size_t numPhi;
+    std::string tri_accel;
     RTCDeviceRef device;
     Ref<VerifyScene> scene;
     static const size_t numRays = 16*1024*1024;
     static const size_t deltaRays = 1024;
     
-    IncoherentRaysBenchmark (std::string name, int isa, GeometryType gtype, RTCSceneFlags sflags, RTCGeometryFlags gflags, IntersectMode imode, IntersectVariant ivariant, size_t numPhi)
-      : ParallelIntersectBenchmark(name,isa,numRays,deltaRays), gtype(gtype), sflags(sflags), gflags(gflags), imode(imode), ivariant(ivariant), numPhi(numPhi), device(nullptr)  {}
+    IncoherentRaysBenchmark (std::string name, int isa, GeometryType gtype, RTCSceneFlags sflags, RTCGeometryFlags gflags, IntersectMode imode, IntersectVariant ivariant, size_t numPhi, std::string tri_accel = "")
+      : ParallelIntersectBenchmark(name,isa,numRays,deltaRays), gtype(gtype), sflags(sflags), gflags(gflags), imode(imode), ivariant(ivariant), numPhi(numPhi), tri_accel(tri_accel), device(nullptr)  {}
 
     size_t setNumPrimitives(size_t N) 
     { 
@@ -3766,6 +4691,7 @@ namespace embree
         return false;
 
       std::string cfg = state->rtcore + ",start_threads=1,set_affinity=1,isa="+stringOfISA(isa);
+      if (tri_accel != "") cfg += ",tri_accel="+tri_accel;
       device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcDeviceGetError(device));
       rtcDeviceSetErrorFunction2(device,errorHandler,nullptr);
@@ -4199,6 +5125,13 @@ namespace embree
       for (auto sflags : sceneFlagsDynamic) 
         groups.top()->add(new UserGeometryIDTest(to_string(sflags),isa,sflags));
       groups.pop();
+
+      push(new TestGroup("bulk_geometry_creation",true,true));
+      for (auto sflags : sceneFlagsDynamic) {
+        groups.top()->add(new BulkGeometryCreationTest(to_string(sflags)+".triangles",isa,sflags,RTC_GEOMETRY_TYPE_TRIANGLE_MESH));
+        groups.top()->add(new BulkGeometryCreationTest(to_string(sflags)+".quads",isa,sflags,RTC_GEOMETRY_TYPE_QUAD_MESH));
+      }
+      groups.pop();
       
       push(new TestGroup("enable_disable_geometry",true,true));
       for (auto sflags : sceneFlagsDynamic) 
@@ -4302,6 +5235,72 @@ namespace embree
         groups.pop();
       }
       
+      if (!rtcDeviceGetParameter1i(device,RTC_CONFIG_BACKFACE_CULLING)) 
+      {
+        push(new TestGroup("geometry_backface_culling",true,true));
+        for (auto gtype : { TRIANGLE_MESH, TRIANGLE_MESH_MB, QUAD_MESH, QUAD_MESH_MB })
+          for (auto sflags : sceneFlags) 
+            for (auto imode : intersectModes) 
+              for (auto ivariant : intersectVariants)
+                if (has_variant(imode,ivariant))
+                    groups.top()->add(new GeometryBackfaceCullingTest(to_string(gtype,sflags,imode,ivariant),isa,sflags,gtype,imode,ivariant));
+        groups.pop();
+      }
+      
+      push(new TestGroup("motion_blur_spatial_splits",true,true));
+      for (auto gtype : { TRIANGLE_MESH_MB, QUAD_MESH_MB })
+        for (auto imode : intersectModes) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new MotionBlurSpatialSplitTest(to_string(gtype)+"."+to_string(imode,ivariant),isa,gtype,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("chunked_build",true,true));
+      for (auto sflags : { RTC_SCENE_STATIC, RTC_SCENE_STATIC | RTC_SCENE_HIGH_QUALITY })
+        for (auto imode : intersectModes) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new ChunkedBuildTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("merged_geometries",true,true));
+      for (auto gflags : { RTC_GEOMETRY_STATIC, RTC_GEOMETRY_DEFORMABLE, RTC_GEOMETRY_DYNAMIC })
+        for (auto imode : intersectModes) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new MergedGeometryTest(to_string(gflags)+"."+to_string(imode,ivariant),isa,gflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("build_threads",true,true));
+      for (auto sflags : { RTC_SCENE_STATIC, RTC_SCENE_HIGH_QUALITY, RTC_SCENE_DYNAMIC }) {
+        groups.top()->add(new BuildThreadsTest(to_string(sflags)+".threads1.low",   isa,sflags,1,RTC_BUILD_PRIORITY_LOW));
+        groups.top()->add(new BuildThreadsTest(to_string(sflags)+".threads2.normal",isa,sflags,2,RTC_BUILD_PRIORITY_NORMAL));
+        groups.top()->add(new BuildThreadsTest(to_string(sflags)+".threads0.high",  isa,sflags,0,RTC_BUILD_PRIORITY_HIGH));
+      }
+      groups.pop();
+
+      push(new TestGroup("block_pool",true,true));
+      groups.top()->add(new BlockPoolTest("disabled",isa,"alloc_pool=0"));
+      groups.top()->add(new BlockPoolTest("scene",isa,"alloc_pool=1,alloc_pool_trim_commits=2"));
+      groups.top()->add(new BlockPoolTest("device",isa,"alloc_pool=1,alloc_pool_shared=1,alloc_pool_trim_commits=2"));
+      groups.pop();
+
+      push(new TestGroup("bvh_compaction",true,true));
+      for (auto sflags : { RTC_SCENE_STATIC, RTC_SCENE_HIGH_QUALITY, RTC_SCENE_STATIC | RTC_SCENE_ROBUST, RTC_SCENE_DYNAMIC })
+        groups.top()->add(new BVHCompactionTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("allocator_functions",true,true));
+      for (auto sflags : { RTC_SCENE_STATIC, RTC_SCENE_HIGH_QUALITY, RTC_SCENE_DYNAMIC })
+        groups.top()->add(new AllocatorFunctionsTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      /* the external tasking system is a global setting, thus these tests cannot run in parallel */
+      push(new TestGroup("external_tasking",true,false));
+      for (auto sflags : { RTC_SCENE_STATIC, RTC_SCENE_HIGH_QUALITY, RTC_SCENE_DYNAMIC })
+        groups.top()->add(new ExternalTaskingTest(to_string(sflags),isa,sflags));
+      groups.pop();
+      
       push(new TestGroup("intersection_filter",true,true));
       if (rtcDeviceGetParameter1i(device,RTC_CONFIG_INTERSECTION_FILTER)) 
       {
@@ -4316,6 +5315,11 @@ namespace embree
             for (auto ivariant : intersectVariants)
               if (has_variant(imode,ivariant))
                   groups.top()->add(new IntersectionFilterTest("subdiv."+to_string(sflags,imode,ivariant),isa,sflags,RTC_GEOMETRY_STATIC,true,imode,ivariant));
+
+        for (auto sflags : sceneFlags) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(MODE_INTERSECT1,ivariant))
+              groups.top()->add(new IntersectionFilterBatchTest("batch."+to_string(sflags,MODE_INTERSECT1,ivariant),isa,sflags,MODE_INTERSECT1,ivariant));
       }
       groups.pop();
       
@@ -4471,6 +5475,10 @@ namespace embree
       };
 
       groups.top()->add(new SimpleBenchmark("simple",isa));
+      groups.top()->add(new TaskingBenchmark("tasking_1",isa,1));
+      groups.top()->add(new TaskingBenchmark("tasking_64",isa,64));
+      groups.top()->add(new TaskingIdleBenchmark("tasking_idle_cpu",isa,true));
+      groups.top()->add(new TaskingIdleBenchmark("tasking_wakeup",isa,false));
       
       for (auto gtype : benchmark_gtypes)
         for (auto sflags : benchmark_sflags_gflags) 
@@ -4484,6 +5492,20 @@ namespace embree
             groups.top()->add(new IncoherentRaysBenchmark("incoherent."+to_string(gtype)+"_1000k."+to_string(sflags.first,imode.first,imode.second),
                                                           isa,gtype,sflags.first,sflags.second,imode.first,imode.second,501));
 
+      /* compare 8-wide triangle leaves against the 4-wide leaves of the BVH8 */
+      if ((isa & AVX) == AVX)
+      {
+        const char* benchmark_tri_accels[] = { "bvh8.triangle4", "bvh8.triangle8" };
+        for (auto tri_accel : benchmark_tri_accels)
+          for (auto imode : benchmark_imodes_ivariants)
+          {
+            groups.top()->add(new CoherentRaysBenchmark("coherent."+to_string(TRIANGLE_MESH)+"_1000k."+tri_accel+"."+to_string(RTC_SCENE_STATIC,imode.first,imode.second),
+                                                        isa,TRIANGLE_MESH,RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,imode.first,imode.second,501,tri_accel));
+            groups.top()->add(new IncoherentRaysBenchmark("incoherent."+to_string(TRIANGLE_MESH)+"_1000k."+tri_accel+"."+to_string(RTC_SCENE_STATIC,imode.first,imode.second),
+                                                          isa,TRIANGLE_MESH,RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC,imode.first,imode.second,501,tri_accel));
+          }
+      }
+
       std::vector<std::pair<RTCSceneFlags,RTCGeometryFlags>> benchmark_create_sflags_gflags;
       benchmark_create_sflags_gflags.push_back(std::make_pair(RTC_SCENE_STATIC,RTC_GEOMETRY_STATIC));
       //benchmark_create_sflags_gflags.push_back(std::make_pair(RTC_SCENE_DYNAMIC,RTC_GEOMETRY_STATIC));